@@ -0,0 +1,217 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+enum class Distribution { UNIFORM, SORTED, SKEWED };
+
+inline const char* toString(Distribution distribution) {
+  switch (distribution) {
+    case Distribution::UNIFORM:
+      return "uniform";
+    case Distribution::SORTED:
+      return "sorted";
+    case Distribution::SKEWED:
+      return "skewed";
+  }
+
+  return "unknown";
+}
+
+// Keeps the compiler from optimizing away a value computed by a benchmark.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Generates `size` keys following the given distribution. Uniform keys are
+// drawn from [0, 4 * size), sorted keys are 0..size-1 and skewed keys follow
+// a power law so that a few small keys make up most of the input.
+inline std::vector<int> generateKeys(std::size_t size,
+                                     Distribution distribution,
+                                     unsigned seed = 42) {
+  std::vector<int> keys(size);
+  std::mt19937 generator(seed);
+
+  switch (distribution) {
+    case Distribution::UNIFORM: {
+      std::uniform_int_distribution<int> uniform(
+          0, static_cast<int>(4 * size - 1));
+      for (auto& key : keys) key = uniform(generator);
+      break;
+    }
+    case Distribution::SORTED:
+      for (std::size_t i = 0; i < size; ++i) keys[i] = static_cast<int>(i);
+      break;
+    case Distribution::SKEWED: {
+      std::uniform_real_distribution<double> real(0.0, 1.0);
+      for (auto& key : keys) {
+        key = static_cast<int>(size * std::pow(real(generator), 4.0));
+      }
+      break;
+    }
+  }
+
+  return keys;
+}
+
+struct Result {
+  std::string group;
+  std::string implementation;
+  std::string operation;
+  std::string distribution;
+  std::size_t size;
+  std::size_t ops;
+  double total_ns;
+  double p50_ns;
+  double p99_ns;
+  std::string skipped;
+};
+
+class Run {
+ public:
+  // Operations are timed in batches so that the clock overhead does not
+  // dominate cheap operations. Latencies are reported per operation.
+  static const std::size_t BATCH_SIZE = 16;
+
+ public:
+  Run(std::size_t size, Distribution distribution)
+      : size_(size),
+        distribution_(distribution),
+        keys_(generateKeys(size, distribution)),
+        ops_(0),
+        total_ns_(0) {}
+
+  std::size_t size() const { return size_; }
+
+  Distribution distribution() const { return distribution_; }
+
+  const std::vector<int>& keys() const { return keys_; }
+
+  // Keys to look up, drawn from the inserted keys in random order.
+  std::vector<int> probes(std::size_t count, unsigned seed = 7) const {
+    std::vector<int> probes(count);
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<std::size_t> index(0, keys_.size() - 1);
+    for (auto& probe : probes) probe = keys_[index(generator)];
+
+    return probes;
+  }
+
+  template <typename Op>
+  void measure(std::size_t ops, Op&& op) {
+    using clock = std::chrono::steady_clock;
+
+    samples_.reserve(samples_.size() + ops / BATCH_SIZE + 1);
+
+    for (std::size_t first = 0; first < ops; first += BATCH_SIZE) {
+      auto last = std::min(ops, first + BATCH_SIZE);
+      auto start = clock::now();
+      for (auto i = first; i < last; ++i) op(i);
+      auto elapsed = std::chrono::duration<double, std::nano>(clock::now() -
+                                                              start)
+                         .count();
+
+      total_ns_ += elapsed;
+      samples_.push_back(elapsed / (last - first));
+    }
+
+    ops_ += ops;
+  }
+
+  void skip(const std::string& reason) { skipped_ = reason; }
+
+  Result result(const std::string& group, const std::string& implementation,
+                const std::string& operation) {
+    Result result = {group,  implementation, operation, toString(distribution_),
+                     size_,  ops_,           total_ns_, percentile(0.5),
+                     percentile(0.99), skipped_};
+
+    return result;
+  }
+
+ private:
+  double percentile(double rank) {
+    if (samples_.empty()) {
+      return 0;
+    }
+
+    auto nth = samples_.begin() +
+               static_cast<std::ptrdiff_t>(rank * (samples_.size() - 1));
+    std::nth_element(samples_.begin(), nth, samples_.end());
+
+    return *nth;
+  }
+
+ private:
+  std::size_t size_;
+  Distribution distribution_;
+  std::vector<int> keys_;
+  std::vector<double> samples_;
+  std::size_t ops_;
+  double total_ns_;
+  std::string skipped_;
+};
+
+struct Benchmark {
+  std::string group;
+  std::string implementation;
+  std::string operation;
+  std::size_t max_size;
+  std::function<void(Run&)> func;
+};
+
+inline std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+struct Registrar {
+  Registrar(const char* group, const char* implementation,
+            const char* operation, std::size_t max_size,
+            void (*func)(Run&)) {
+    registry().push_back({group, implementation, operation, max_size, func});
+  }
+};
+
+}  // namespace bench
+
+// Defines a benchmark of `operation` on `implementation`. Benchmarks sharing a
+// `group` measure the same workload and are meant to be compared, e.g. the
+// library's LinkedList against std::list. Sizes above `max_size` are skipped.
+#define BENCHMARK(id, group, implementation, operation, max_size)       \
+  static void id(bench::Run& run);                                      \
+  static const bench::Registrar id##_registrar(group, implementation,   \
+                                               operation, max_size, id); \
+  static void id(bench::Run& run)
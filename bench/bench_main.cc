@@ -0,0 +1,230 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/bench.hpp"
+
+namespace {
+
+struct Options {
+  std::vector<std::size_t> sizes = {1000, 10000, 100000, 1000000, 10000000};
+  std::vector<bench::Distribution> distributions = {
+      bench::Distribution::UNIFORM, bench::Distribution::SORTED,
+      bench::Distribution::SKEWED};
+  std::size_t max_size = 10000000;
+  std::string filter;
+  std::string out;
+};
+
+std::vector<std::string> split(const std::string& value) {
+  std::vector<std::string> parts;
+  std::stringstream ss(value);
+  std::string part;
+  while (std::getline(ss, part, ',')) {
+    if (!part.empty()) parts.push_back(part);
+  }
+
+  return parts;
+}
+
+bool parseOption(const char* arg, const char* name, std::string* value) {
+  auto length = std::strlen(name);
+  if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') {
+    return false;
+  }
+
+  *value = arg + length + 1;
+  return true;
+}
+
+void usage() {
+  std::cerr << "usage: bench.bin [options]\n"
+               "  --filter=SUBSTR          run benchmarks whose name contains "
+               "SUBSTR\n"
+               "  --sizes=N,N,...          element counts (default 1e3..1e7)\n"
+               "  --max-size=N             skip sizes above N\n"
+               "  --distributions=D,D,...  uniform, sorted, skewed\n"
+               "  --out=FILE               write JSON to FILE instead of "
+               "stdout\n";
+}
+
+bool parseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+
+    if (parseOption(argv[i], "--filter", &value)) {
+      options->filter = value;
+    } else if (parseOption(argv[i], "--sizes", &value)) {
+      options->sizes.clear();
+      for (auto& size : split(value)) {
+        options->sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+        if (!options->sizes.back()) {
+          std::cerr << "sizes must be positive numbers: " << size << "\n";
+          return false;
+        }
+      }
+    } else if (parseOption(argv[i], "--max-size", &value)) {
+      options->max_size = std::strtoull(value.c_str(), nullptr, 10);
+      if (!options->max_size) {
+        std::cerr << "max size must be a positive number: " << value << "\n";
+        return false;
+      }
+    } else if (parseOption(argv[i], "--distributions", &value)) {
+      options->distributions.clear();
+      for (auto& name : split(value)) {
+        if (name == "uniform") {
+          options->distributions.push_back(bench::Distribution::UNIFORM);
+        } else if (name == "sorted") {
+          options->distributions.push_back(bench::Distribution::SORTED);
+        } else if (name == "skewed") {
+          options->distributions.push_back(bench::Distribution::SKEWED);
+        } else {
+          std::cerr << "unknown distribution: " << name << "\n";
+          return false;
+        }
+      }
+    } else if (parseOption(argv[i], "--out", &value)) {
+      options->out = value;
+    } else {
+      usage();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string escape(const std::string& value) {
+  std::string escaped;
+  for (auto c : value) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+
+  return escaped;
+}
+
+void writeJson(std::ostream& out, const std::vector<bench::Result>& results) {
+  char date[32];
+  auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"compiler\": \"" << escape(__VERSION__) << "\",\n"
+      << "    \"batch_size\": " << bench::Run::BATCH_SIZE << "\n"
+      << "  },\n  \"benchmarks\": [";
+
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    auto& result = results[i];
+
+    out << (i ? ",\n" : "\n") << "    {\"group\": \"" << escape(result.group)
+        << "\", \"implementation\": \"" << escape(result.implementation)
+        << "\", \"operation\": \"" << escape(result.operation)
+        << "\", \"distribution\": \"" << result.distribution
+        << "\", \"size\": " << result.size;
+
+    if (!result.skipped.empty()) {
+      out << ", \"skipped\": \"" << escape(result.skipped) << "\"}";
+      continue;
+    }
+
+    auto nsPerOp = result.ops ? result.total_ns / result.ops : 0;
+    out << ", \"ops\": " << result.ops << ", \"ns_per_op\": " << nsPerOp
+        << ", \"ops_per_sec\": " << (nsPerOp > 0 ? 1e9 / nsPerOp : 0)
+        << ", \"p50_ns\": " << result.p50_ns
+        << ", \"p99_ns\": " << result.p99_ns << "}";
+  }
+
+  out << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, &options)) {
+    return 1;
+  }
+
+  std::vector<bench::Result> results;
+
+  for (auto& benchmark : bench::registry()) {
+    auto name = benchmark.implementation + "/" + benchmark.operation;
+    if (name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+
+    for (auto size : options.sizes) {
+      // Capped sizes are reported as skipped, so the gap shows up when
+      // results are compared across benchmarks.
+      std::string skipped;
+      if (size > options.max_size) {
+        skipped = "size above --max-size";
+      } else if (size > benchmark.max_size) {
+        skipped = "size above the benchmark limit of " +
+                  std::to_string(benchmark.max_size);
+      }
+
+      for (auto distribution : options.distributions) {
+        if (!skipped.empty()) {
+          bench::Result result = {benchmark.group,
+                                  benchmark.implementation,
+                                  benchmark.operation,
+                                  bench::toString(distribution),
+                                  size,
+                                  0,
+                                  0,
+                                  0,
+                                  0,
+                                  skipped};
+          results.push_back(result);
+          continue;
+        }
+
+        std::cerr << name << "/" << bench::toString(distribution) << "/"
+                  << size << std::endl;
+
+        bench::Run run(size, distribution);
+        benchmark.func(run);
+        results.push_back(run.result(benchmark.group, benchmark.implementation,
+                                     benchmark.operation));
+      }
+    }
+  }
+
+  if (options.out.empty()) {
+    writeJson(std::cout, results);
+  } else {
+    std::ofstream out(options.out);
+    writeJson(out, results);
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <vector>
+#include "bench/bench.hpp"
+#include "comparator.hpp"
+
+// Each operation scans the whole span, so only a few are measured.
+static const std::size_t SCAN_OPS = 16;
+
+BENCHMARK(Comparator_minIndex, "Comparator", "Comparator::minIndex",
+          "min_index", 10000000) {
+  Comparator<int> comparator;
+  auto& keys = run.keys();
+
+  run.measure(SCAN_OPS, [&](std::size_t) {
+    bench::doNotOptimize(comparator.minIndex(keys.data(), keys.size()));
+  });
+}
+
+BENCHMARK(ScalarBatchCompare_minIndex, "Comparator", "scalar", "min_index",
+          10000000) {
+  DefaultCompare<int> compare;
+  auto& keys = run.keys();
+
+  run.measure(SCAN_OPS, [&](std::size_t) {
+    bench::doNotOptimize(ScalarBatchCompare<int, DefaultCompare<int>>::minIndex(
+        compare, keys.data(), keys.size()));
+  });
+}
+
+BENCHMARK(StdMinElement_minIndex, "Comparator", "std::min_element",
+          "min_index", 10000000) {
+  auto& keys = run.keys();
+
+  run.measure(SCAN_OPS, [&](std::size_t) {
+    bench::doNotOptimize(std::min_element(keys.begin(), keys.end()));
+  });
+}
+
+BENCHMARK(Comparator_compareMany, "Comparator", "Comparator::compareMany",
+          "compare_many", 10000000) {
+  Comparator<int> comparator;
+  auto& keys = run.keys();
+  std::vector<int> results(keys.size());
+
+  run.measure(SCAN_OPS, [&](std::size_t i) {
+    comparator.compareMany(keys[i % keys.size()], keys.data(), keys.size(),
+                           results.data());
+    bench::doNotOptimize(results.data());
+  });
+}
+
+BENCHMARK(ScalarBatchCompare_compareMany, "Comparator", "scalar",
+          "compare_many", 10000000) {
+  DefaultCompare<int> compare;
+  auto& keys = run.keys();
+  std::vector<int> results(keys.size());
+
+  run.measure(SCAN_OPS, [&](std::size_t i) {
+    ScalarBatchCompare<int, DefaultCompare<int>>::compareMany(
+        compare, keys[i % keys.size()], keys.data(), keys.size(),
+        results.data());
+    bench::doNotOptimize(results.data());
+  });
+}
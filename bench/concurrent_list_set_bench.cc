@@ -0,0 +1,107 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench/bench.hpp"
+#include "concurrent_list_set.hpp"
+#include "linked_list.hpp"
+
+// Lookups are O(n), so they only run up to this size.
+static const std::size_t MAX_SCAN_SIZE = 10000;
+static const std::size_t OPS_PER_THREAD = 20000;
+
+// The way sets were shared before: a LinkedList behind a mutex.
+class LockedListSet {
+ public:
+  bool insert(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (list_.find(value)) return false;
+    list_.append(value);
+    return true;
+  }
+
+  bool remove(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return list_.remove(value) != nullptr;
+  }
+
+  bool contains(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return list_.find(value) != nullptr;
+  }
+
+ private:
+  std::mutex mutex_;
+  LinkedList<int> list_;
+};
+
+// Every thread runs OPS_PER_THREAD operations, one in ten is a write. Timed
+// per operation over all threads.
+template <typename Set>
+static void readMostly(bench::Run& run, std::size_t threadCount) {
+  Set set;
+  for (auto key : run.keys()) set.insert(key);
+  auto probes = run.probes(OPS_PER_THREAD);
+
+  run.measure(threadCount * OPS_PER_THREAD, [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&set, &probes, t]() {
+        for (std::size_t j = 0; j < probes.size(); ++j) {
+          auto key = probes[(j + t * 7919) % probes.size()];
+          if (j % 20 == 0) {
+            set.remove(key);
+          } else if (j % 20 == 10) {
+            set.insert(key);
+          } else {
+            bench::doNotOptimize(set.contains(key));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  });
+}
+
+BENCHMARK(ConcurrentListSet_readMostly1, "ConcurrentListSet",
+          "ConcurrentListSet", "readMostly/1 thread", MAX_SCAN_SIZE) {
+  readMostly<ConcurrentListSet<int>>(run, 1);
+}
+
+BENCHMARK(LockedListSet_readMostly1, "ConcurrentListSet",
+          "LinkedList+mutex", "readMostly/1 thread", MAX_SCAN_SIZE) {
+  readMostly<LockedListSet>(run, 1);
+}
+
+BENCHMARK(ConcurrentListSet_readMostly4, "ConcurrentListSet",
+          "ConcurrentListSet", "readMostly/4 threads", MAX_SCAN_SIZE) {
+  readMostly<ConcurrentListSet<int>>(run, 4);
+}
+
+BENCHMARK(LockedListSet_readMostly4, "ConcurrentListSet",
+          "LinkedList+mutex", "readMostly/4 threads", MAX_SCAN_SIZE) {
+  readMostly<LockedListSet>(run, 4);
+}
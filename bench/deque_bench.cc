@@ -0,0 +1,92 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <deque>
+#include "bench/bench.hpp"
+#include "deque.hpp"
+
+BENCHMARK(Deque_pushFront, "Deque", "Deque", "pushFront", 10000000) {
+  Deque<int> deque;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { deque.pushFront(keys[i]); });
+}
+
+BENCHMARK(StdDeque_pushFront, "Deque", "std::deque", "pushFront", 10000000) {
+  std::deque<int> deque;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { deque.push_front(keys[i]); });
+}
+
+BENCHMARK(Deque_pushBack, "Deque", "Deque", "pushBack", 10000000) {
+  Deque<int> deque;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { deque.pushBack(keys[i]); });
+}
+
+BENCHMARK(StdDeque_pushBack, "Deque", "std::deque", "pushBack", 10000000) {
+  std::deque<int> deque;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { deque.push_back(keys[i]); });
+}
+
+// Keeps size items queued while every operation pushes one item at the back
+// and pops another at the front, the way a sliding window moves.
+BENCHMARK(Deque_churn, "Deque", "Deque", "churn", 10000000) {
+  Deque<int> deque;
+  for (auto key : run.keys()) deque.pushBack(key);
+
+  run.measure(run.size(), [&](std::size_t i) {
+    deque.pushBack(run.keys()[i]);
+    bench::doNotOptimize(deque.popFront());
+  });
+}
+
+BENCHMARK(StdDeque_churn, "Deque", "std::deque", "churn", 10000000) {
+  std::deque<int> deque;
+  for (auto key : run.keys()) deque.push_back(key);
+
+  run.measure(run.size(), [&](std::size_t i) {
+    deque.push_back(run.keys()[i]);
+    bench::doNotOptimize(deque.front());
+    deque.pop_front();
+  });
+}
+
+BENCHMARK(Deque_index, "Deque", "Deque", "index", 10000000) {
+  Deque<int> deque;
+  for (auto key : run.keys()) deque.pushFront(key);
+
+  run.measure(run.size(),
+              [&](std::size_t i) { bench::doNotOptimize(deque[i]); });
+}
+
+BENCHMARK(StdDeque_index, "Deque", "std::deque", "index", 10000000) {
+  std::deque<int> deque;
+  for (auto key : run.keys()) deque.push_front(key);
+
+  run.measure(run.size(),
+              [&](std::size_t i) { bench::doNotOptimize(deque[i]); });
+}
@@ -0,0 +1,84 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bench/bench.hpp"
+#include "hash_table.hpp"
+
+// HashTable has a fixed number of buckets, so operations are O(n / N).
+static const std::size_t MAX_TABLE_SIZE = 100000;
+
+static std::vector<std::string> toStrings(const std::vector<int>& keys) {
+  std::vector<std::string> strings;
+  strings.reserve(keys.size());
+  for (auto key : keys) strings.push_back(std::to_string(key));
+
+  return strings;
+}
+
+BENCHMARK(HashTable_set, "HashTable", "HashTable", "set", MAX_TABLE_SIZE) {
+  HashTable<int> table;
+  auto keys = toStrings(run.keys());
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    table.set(keys[i], static_cast<int>(i));
+  });
+}
+
+BENCHMARK(StdUnorderedMap_set, "HashTable", "std::unordered_map", "set",
+          10000000) {
+  std::unordered_map<std::string, int> table;
+  auto keys = toStrings(run.keys());
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    table[keys[i]] = static_cast<int>(i);
+  });
+}
+
+BENCHMARK(HashTable_get, "HashTable", "HashTable", "get", MAX_TABLE_SIZE) {
+  HashTable<int> table;
+  auto keys = toStrings(run.keys());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    table.set(keys[i], static_cast<int>(i));
+  }
+  auto probes = toStrings(run.probes(run.size()));
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(table.get(probes[i]));
+  });
+}
+
+BENCHMARK(StdUnorderedMap_get, "HashTable", "std::unordered_map", "get",
+          10000000) {
+  std::unordered_map<std::string, int> table;
+  auto keys = toStrings(run.keys());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    table[keys[i]] = static_cast<int>(i);
+  }
+  auto probes = toStrings(run.probes(run.size()));
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(table.find(probes[i]));
+  });
+}
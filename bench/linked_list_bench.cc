@@ -0,0 +1,226 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <list>
+#include <vector>
+#include "bench/bench.hpp"
+#include "doubly_linked_list.hpp"
+#include "linked_list.hpp"
+#include "node_pool.hpp"
+#include "pooled_linked_list.hpp"
+#include "unrolled_linked_list.hpp"
+
+// Lookups are O(n), so they only run up to this size.
+static const std::size_t MAX_SCAN_SIZE = 100000;
+static const std::size_t SCAN_OPS = 1000;
+
+BENCHMARK(LinkedList_append, "LinkedList", "LinkedList", "append",
+          10000000) {
+  LinkedList<int> list;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { list.append(keys[i]); });
+}
+
+BENCHMARK(PooledLinkedList_append, "LinkedList", "PooledLinkedList", "append",
+          10000000) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { list.append(keys[i]); });
+}
+
+BENCHMARK(StdList_append, "LinkedList", "std::list", "append", 10000000) {
+  std::list<int> list;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { list.push_back(keys[i]); });
+}
+
+BENCHMARK(LinkedList_find, "LinkedList", "LinkedList", "find", MAX_SCAN_SIZE) {
+  LinkedList<int> list;
+  for (auto key : run.keys()) list.append(key);
+  auto probes = run.probes(SCAN_OPS);
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(list.find(probes[i]));
+  });
+}
+
+BENCHMARK(PooledLinkedList_find, "LinkedList", "PooledLinkedList", "find",
+          MAX_SCAN_SIZE) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+  for (auto key : run.keys()) list.append(key);
+  auto probes = run.probes(SCAN_OPS);
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(list.find(probes[i]));
+  });
+}
+
+BENCHMARK(StdList_find, "LinkedList", "std::list", "find", MAX_SCAN_SIZE) {
+  std::list<int> list(run.keys().begin(), run.keys().end());
+  auto probes = run.probes(SCAN_OPS);
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(std::find(list.begin(), list.end(), probes[i]));
+  });
+}
+
+BENCHMARK(UnrolledLinkedList_find, "LinkedList", "UnrolledLinkedList", "find",
+          MAX_SCAN_SIZE) {
+  UnrolledLinkedList<int> list;
+  for (auto key : run.keys()) list.append(key);
+  auto probes = run.probes(SCAN_OPS);
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(list.find(probes[i]));
+  });
+}
+
+BENCHMARK(StdVector_find, "LinkedList", "std::vector", "find", MAX_SCAN_SIZE) {
+  std::vector<int> vector(run.keys());
+  auto probes = run.probes(SCAN_OPS);
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(std::find(vector.begin(), vector.end(), probes[i]));
+  });
+}
+
+BENCHMARK(LinkedList_deleteHead, "LinkedList", "LinkedList", "deleteHead",
+          10000000) {
+  LinkedList<int> list;
+  for (auto key : run.keys()) list.append(key);
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(list.deleteHead());
+  });
+}
+
+BENCHMARK(StdList_deleteHead, "LinkedList", "std::list", "deleteHead",
+          10000000) {
+  std::list<int> list(run.keys().begin(), run.keys().end());
+
+  run.measure(run.size(), [&](std::size_t) { list.pop_front(); });
+}
+
+// Appends to the tail and deletes the head of a warmed up list, both lists
+// taking their nodes from a NodePool.
+BENCHMARK(LinkedListPooled_churn, "LinkedList", "LinkedList pooled",
+          "churn", 10000000) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  LinkedList<int, DefaultCompare<int>, NoStats, PoolAllocator<int>> list(
+      DefaultCompare<int>(), allocator);
+  for (auto key : run.keys()) list.append(key);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    list.append(keys[i]);
+    bench::doNotOptimize(list.deleteHead());
+  });
+}
+
+BENCHMARK(PooledLinkedList_churn, "LinkedList", "PooledLinkedList", "churn",
+          10000000) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+  for (auto key : run.keys()) list.append(key);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    list.append(keys[i]);
+    bench::doNotOptimize(list.deleteHead());
+  });
+}
+
+// Every deleteTail walks the whole list, so only SCAN_OPS of them are run.
+BENCHMARK(LinkedList_deleteTail, "LinkedList", "LinkedList", "deleteTail",
+          MAX_SCAN_SIZE) {
+  LinkedList<int> list;
+  for (auto key : run.keys()) list.append(key);
+
+  run.measure(std::min(run.size(), SCAN_OPS), [&](std::size_t) {
+    bench::doNotOptimize(list.deleteTail());
+  });
+}
+
+BENCHMARK(DoublyLinkedList_deleteTail, "LinkedList", "DoublyLinkedList",
+          "deleteTail", 10000000) {
+  DoublyLinkedList<int> list;
+  for (auto key : run.keys()) list.append(key);
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(list.deleteTail());
+  });
+}
+
+BENCHMARK(StdList_deleteTail, "LinkedList", "std::list", "deleteTail",
+          10000000) {
+  std::list<int> list(run.keys().begin(), run.keys().end());
+
+  run.measure(run.size(), [&](std::size_t) { list.pop_back(); });
+}
+
+BENCHMARK(LinkedList_appendRange, "LinkedList", "LinkedList", "appendRange",
+          10000000) {
+  LinkedList<int> list;
+  auto& keys = run.keys();
+
+  // One call appends everything, timed per element like append.
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i == 0) list.appendRange(keys.begin(), keys.end());
+  });
+}
+
+BENCHMARK(LinkedList_sort, "LinkedList", "LinkedList", "sort", 10000000) {
+  LinkedList<int> list;
+  list.appendRange(run.keys().begin(), run.keys().end());
+
+  run.measure(1, [&](std::size_t) { list.sort(); });
+}
+
+// The way lists were sorted before: copy out, sort and rebuild.
+BENCHMARK(LinkedList_sortThroughVector, "LinkedList", "LinkedList+vector",
+          "sort", 10000000) {
+  LinkedList<int> list;
+  list.appendRange(run.keys().begin(), run.keys().end());
+
+  run.measure(1, [&](std::size_t) {
+    std::vector<int> values(list.begin(), list.end());
+    std::stable_sort(values.begin(), values.end());
+    list.clear();
+    for (auto value : values) list.append(value);
+  });
+}
+
+BENCHMARK(StdList_sort, "LinkedList", "std::list", "sort", 10000000) {
+  std::list<int> list(run.keys().begin(), run.keys().end());
+
+  run.measure(1, [&](std::size_t) { list.sort(); });
+}
@@ -0,0 +1,147 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/bench.hpp"
+#include "min_heap.hpp"
+
+using StdMinHeap =
+    std::priority_queue<int, std::vector<int>, std::greater<int>>;
+
+namespace {
+// Case insensitive sort key, costly enough to be worth caching.
+struct LowerCaseKey {
+  std::string operator()(const std::string& value) const {
+    std::string key(value);
+    for (auto& character : key) {
+      character = static_cast<char>(
+          std::tolower(static_cast<unsigned char>(character)));
+    }
+    return key;
+  }
+};
+
+struct LowerCaseCompare {
+  int operator()(const std::string& a, const std::string& b) const {
+    return LowerCaseKey()(a).compare(LowerCaseKey()(b));
+  }
+};
+
+std::vector<std::string> toNames(const std::vector<int>& keys) {
+  std::vector<std::string> names;
+  names.reserve(keys.size());
+  for (auto key : keys) {
+    names.push_back("Name_" + std::to_string(key) + "_Suffix");
+  }
+  return names;
+}
+}  // namespace
+
+BENCHMARK(MinHeap_add, "MinHeap", "MinHeap", "add", 10000000) {
+  MinHeap<int> heap;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { heap.add(keys[i]); });
+}
+
+BENCHMARK(StdPriorityQueue_add, "MinHeap", "std::priority_queue", "add",
+          10000000) {
+  StdMinHeap heap;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { heap.push(keys[i]); });
+}
+
+BENCHMARK(MinHeap_poll, "MinHeap", "MinHeap", "poll", 10000000) {
+  MinHeap<int> heap;
+  for (auto key : run.keys()) heap.add(key);
+
+  run.measure(run.size(),
+              [&](std::size_t) { bench::doNotOptimize(heap.poll()); });
+}
+
+BENCHMARK(StdPriorityQueue_poll, "MinHeap", "std::priority_queue", "poll",
+          10000000) {
+  StdMinHeap heap(run.keys().begin(), run.keys().end());
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(heap.top());
+    heap.pop();
+  });
+}
+
+BENCHMARK(MinHeap_to_string, "MinHeap", "MinHeap", "to_string", 10000000) {
+  MinHeap<int> heap;
+  for (auto key : run.keys()) heap.add(key);
+
+  run.measure(1, [&](std::size_t) { bench::doNotOptimize(heap.toString()); });
+}
+
+BENCHMARK(StdOstringstream_to_string, "MinHeap", "std::ostringstream",
+          "to_string", 10000000) {
+  std::vector<int> heap(run.keys());
+  std::make_heap(heap.begin(), heap.end(), std::greater<int>());
+
+  run.measure(1, [&](std::size_t) {
+    std::ostringstream ss;
+    for (std::size_t i = 0; i < heap.size(); ++i) {
+      if (i) ss << ',';
+      ss << heap[i];
+    }
+    bench::doNotOptimize(ss.str());
+  });
+}
+
+BENCHMARK(MinHeap_add_poll_projected, "MinHeap", "MinHeap projected",
+          "add_poll_string", 1000000) {
+  using compare_t = ProjectionCompare<std::string, LowerCaseKey>;
+  MinHeap<std::string, compare_t> heap;
+  auto names = toNames(run.keys());
+
+  run.measure(names.size() * 2, [&](std::size_t i) {
+    if (i < names.size()) {
+      heap.add(names[i]);
+    } else {
+      bench::doNotOptimize(heap.poll());
+    }
+  });
+}
+
+BENCHMARK(MinHeap_add_poll_compared, "MinHeap", "MinHeap compared",
+          "add_poll_string", 1000000) {
+  MinHeap<std::string, LowerCaseCompare> heap;
+  auto names = toNames(run.keys());
+
+  run.measure(names.size() * 2, [&](std::size_t i) {
+    if (i < names.size()) {
+      heap.add(names[i]);
+    } else {
+      bench::doNotOptimize(heap.poll());
+    }
+  });
+}
@@ -0,0 +1,98 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench/bench.hpp"
+#include "mpmc_queue.hpp"
+#include "queue.hpp"
+
+static const std::size_t CONTENTION_CAPACITY = 1024;
+
+class LockedQueue {
+ public:
+  bool tryEnqueue(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.enqueue(value);
+    return true;
+  }
+
+  bool tryDequeue(int& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.tryDequeue(value);
+  }
+
+ private:
+  std::mutex mutex_;
+  Queue<int> queue_;
+};
+
+class BoundedQueue : public MpmcQueue<int> {
+ public:
+  BoundedQueue() : MpmcQueue<int>(CONTENTION_CAPACITY) {}
+};
+
+// Every thread enqueues its share of the keys and dequeues one value after
+// each, so all of them produce and consume. Threads yield while they wait,
+// which keeps runs with more threads than cores meaningful. Timed per key.
+template <typename Queue>
+static void contention(bench::Run& run, std::size_t threadCount) {
+  Queue queue;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&, t]() {
+        int value;
+        for (auto key = t; key < keys.size(); key += threadCount) {
+          while (!queue.tryEnqueue(keys[key])) std::this_thread::yield();
+          while (!queue.tryDequeue(value)) std::this_thread::yield();
+          bench::doNotOptimize(value);
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  });
+}
+
+// The operation is named after the thread count, e.g. contention/8.
+#define CONTENTION_BENCHMARKS(threads)                                   \
+  BENCHMARK(MpmcQueue_contention##threads, "MpmcQueue", "MpmcQueue",     \
+            "contention/" #threads, 10000000) {                          \
+    contention<BoundedQueue>(run, threads);                              \
+  }                                                                      \
+  BENCHMARK(LockedQueue_contention##threads, "MpmcQueue", "Queue+mutex", \
+            "contention/" #threads, 10000000) {                          \
+    contention<LockedQueue>(run, threads);                               \
+  }
+
+CONTENTION_BENCHMARKS(1)
+CONTENTION_BENCHMARKS(2)
+CONTENTION_BENCHMARKS(4)
+CONTENTION_BENCHMARKS(8)
+CONTENTION_BENCHMARKS(16)
+CONTENTION_BENCHMARKS(32)
+CONTENTION_BENCHMARKS(64)
@@ -0,0 +1,80 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <queue>
+#include <utility>
+#include <vector>
+#include "bench/bench.hpp"
+#include "priority_queue.hpp"
+
+// Every comparison looks both priorities up in a std::map.
+static const std::size_t MAX_QUEUE_SIZE = 1000000;
+
+using StdPriorityQueue =
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
+                        std::greater<std::pair<int, int>>>;
+
+BENCHMARK(PriorityQueue_add, "PriorityQueue", "PriorityQueue", "add",
+          MAX_QUEUE_SIZE) {
+  PriorityQueue<int> queue;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    queue.add(static_cast<int>(i), keys[i]);
+  });
+}
+
+BENCHMARK(StdPriorityQueue_add, "PriorityQueue", "std::priority_queue", "add",
+          10000000) {
+  StdPriorityQueue queue;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    queue.push(std::make_pair(keys[i], static_cast<int>(i)));
+  });
+}
+
+BENCHMARK(PriorityQueue_poll, "PriorityQueue", "PriorityQueue", "poll",
+          MAX_QUEUE_SIZE) {
+  PriorityQueue<int> queue;
+  auto& keys = run.keys();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    queue.add(static_cast<int>(i), keys[i]);
+  }
+
+  run.measure(run.size(),
+              [&](std::size_t) { bench::doNotOptimize(queue.poll()); });
+}
+
+BENCHMARK(StdPriorityQueue_poll, "PriorityQueue", "std::priority_queue",
+          "poll", 10000000) {
+  StdPriorityQueue queue;
+  auto& keys = run.keys();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    queue.push(std::make_pair(keys[i], static_cast<int>(i)));
+  }
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(queue.top());
+    queue.pop();
+  });
+}
@@ -0,0 +1,239 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "bench/bench.hpp"
+#include "blocking_queue.hpp"
+#include "node_pool.hpp"
+#include "queue.hpp"
+#include "spsc_queue.hpp"
+
+BENCHMARK(Queue_enqueue, "Queue", "Queue", "enqueue", 10000000) {
+  Queue<int> queue;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { queue.enqueue(keys[i]); });
+}
+
+BENCHMARK(StdQueue_enqueue, "Queue", "std::queue", "enqueue", 10000000) {
+  std::queue<int> queue;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { queue.push(keys[i]); });
+}
+
+BENCHMARK(Queue_dequeue, "Queue", "Queue", "dequeue", 10000000) {
+  Queue<int> queue;
+  for (auto key : run.keys()) queue.enqueue(key);
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(queue.dequeue());
+  });
+}
+
+BENCHMARK(StdQueue_dequeue, "Queue", "std::queue", "dequeue", 10000000) {
+  std::queue<int> queue;
+  for (auto key : run.keys()) queue.push(key);
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(queue.front());
+    queue.pop();
+  });
+}
+
+// Keeps size items queued while every operation enqueues one item and
+// dequeues another, so nodes are freed as fast as they are allocated.
+BENCHMARK(Queue_churn, "Queue", "Queue", "churn", 10000000) {
+  Queue<int> queue;
+  for (auto key : run.keys()) queue.enqueue(key);
+
+  run.measure(run.size(), [&](std::size_t i) {
+    queue.enqueue(run.keys()[i]);
+    bench::doNotOptimize(queue.dequeue());
+  });
+}
+
+BENCHMARK(PooledQueue_churn, "Queue", "Queue pooled", "churn",
+          10000000) {
+  NodePool pool;
+  Queue<int, NoStats, PoolAllocator<int>> queue((PoolAllocator<int>(&pool)));
+  for (auto key : run.keys()) queue.enqueue(key);
+
+  run.measure(run.size(), [&](std::size_t i) {
+    queue.enqueue(run.keys()[i]);
+    bench::doNotOptimize(queue.dequeue());
+  });
+}
+
+BENCHMARK(StdQueue_churn, "Queue", "std::queue", "churn", 10000000) {
+  std::queue<int> queue;
+  for (auto key : run.keys()) queue.push(key);
+
+  run.measure(run.size(), [&](std::size_t i) {
+    queue.push(run.keys()[i]);
+    bench::doNotOptimize(queue.front());
+    queue.pop();
+  });
+}
+
+// Passes the keys through in blocks, the way a BFS consumes its frontier.
+// Timed per block of BULK_SIZE keys.
+static const std::size_t BULK_SIZE = 64;
+
+BENCHMARK(Queue_bulk, "Queue", "Queue", "bulk", 10000000) {
+  Queue<int> queue;
+  auto& keys = run.keys();
+  std::vector<int> frontier(BULK_SIZE);
+
+  run.measure(keys.size() / BULK_SIZE, [&](std::size_t i) {
+    queue.enqueueBulk(keys.data() + i * BULK_SIZE, BULK_SIZE);
+    bench::doNotOptimize(queue.dequeueBulk(frontier.data(), BULK_SIZE));
+  });
+}
+
+BENCHMARK(Memcpy_bulk, "Queue", "memcpy", "bulk", 10000000) {
+  std::vector<int> buffer(BULK_SIZE);
+  auto& keys = run.keys();
+  std::vector<int> frontier(BULK_SIZE);
+
+  run.measure(keys.size() / BULK_SIZE, [&](std::size_t i) {
+    std::memcpy(buffer.data(), keys.data() + i * BULK_SIZE,
+                BULK_SIZE * sizeof(int));
+    std::memcpy(frontier.data(), buffer.data(), BULK_SIZE * sizeof(int));
+    bench::doNotOptimize(frontier.data());
+  });
+}
+
+// One thread hands the keys to another. Either side yields while it has to
+// wait, so the numbers stay meaningful with fewer cores than threads.
+static const std::size_t HANDOFF_CAPACITY = 1024;
+
+BENCHMARK(SpscQueue_handoff, "Queue", "SpscQueue", "handoff", 10000000) {
+  SpscQueue<int> queue(HANDOFF_CAPACITY);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::thread producer([&]() {
+      for (auto key : keys) {
+        while (!queue.enqueue(key)) std::this_thread::yield();
+      }
+    });
+
+    int value;
+    for (std::size_t received = 0; received < keys.size();) {
+      if (queue.tryDequeue(value)) {
+        bench::doNotOptimize(value);
+        ++received;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    producer.join();
+  });
+}
+
+BENCHMARK(LockedQueue_handoff, "Queue", "Queue+mutex", "handoff", 10000000) {
+  Queue<int> queue;
+  std::mutex mutex;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::thread producer([&]() {
+      for (auto key : keys) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.enqueue(key);
+      }
+    });
+
+    int value;
+    for (std::size_t received = 0; received < keys.size();) {
+      bool dequeued;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        dequeued = queue.tryDequeue(value);
+      }
+
+      if (dequeued) {
+        bench::doNotOptimize(value);
+        ++received;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    producer.join();
+  });
+}
+
+// The consumer sleeps instead of yielding while the queue is empty.
+BENCHMARK(BlockingQueue_handoff, "Queue", "BlockingQueue", "handoff",
+          10000000) {
+  BlockingQueue<int> queue(HANDOFF_CAPACITY);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::thread producer([&]() {
+      for (auto key : keys) queue.enqueue(key);
+    });
+
+    int value;
+    for (std::size_t received = 0; received < keys.size(); ++received) {
+      queue.dequeue(value);
+      bench::doNotOptimize(value);
+    }
+    producer.join();
+  });
+}
+
+BENCHMARK(BlockingQueue_bulkHandoff, "Queue", "BlockingQueue bulk", "handoff",
+          10000000) {
+  BlockingQueue<int> queue(HANDOFF_CAPACITY);
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) {
+    if (i != 0) return;
+
+    std::thread producer([&]() {
+      for (std::size_t first = 0; first < keys.size(); first += BULK_SIZE) {
+        queue.enqueueBulk(keys.data() + first,
+                          std::min(BULK_SIZE, keys.size() - first));
+      }
+    });
+
+    std::vector<int> batch(BULK_SIZE);
+    for (std::size_t received = 0; received < keys.size();) {
+      received += queue.dequeueBulk(batch.data(), BULK_SIZE);
+      bench::doNotOptimize(batch.data());
+    }
+    producer.join();
+  });
+}
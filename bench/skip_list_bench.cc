@@ -0,0 +1,92 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <set>
+#include "bench/bench.hpp"
+#include "red_black_tree.hpp"
+#include "skip_list.hpp"
+
+// Every tree node carries a HashTable for its meta data (the node color).
+static const std::size_t MAX_TREE_SIZE = 100000;
+
+BENCHMARK(SkipList_insert, "SkipList", "SkipList", "insert", 10000000) {
+  SkipList<int> list;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { list.insert(keys[i]); });
+}
+
+BENCHMARK(RedBlackTree_insertOrdered, "SkipList", "RedBlackTree", "insert",
+          MAX_TREE_SIZE) {
+  RedBlackTree<int> tree;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { tree.insert(keys[i]); });
+}
+
+BENCHMARK(StdSet_insertOrdered, "SkipList", "std::set", "insert", 10000000) {
+  std::set<int> set;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { set.insert(keys[i]); });
+}
+
+BENCHMARK(SkipList_find, "SkipList", "SkipList", "find", 10000000) {
+  SkipList<int> list;
+  for (auto key : run.keys()) list.insert(key);
+  auto probes = run.probes(run.size());
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(list.find(probes[i]));
+  });
+}
+
+BENCHMARK(StdSet_findOrdered, "SkipList", "std::set", "find", 10000000) {
+  std::set<int> set(run.keys().begin(), run.keys().end());
+  auto probes = run.probes(run.size());
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(set.find(probes[i]));
+  });
+}
+
+// Write heavy: every step removes a key and inserts it back.
+BENCHMARK(SkipList_churn, "SkipList", "SkipList", "remove+insert", 10000000) {
+  SkipList<int> list;
+  for (auto key : run.keys()) list.insert(key);
+  auto probes = run.probes(run.size());
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    list.remove(probes[i]);
+    list.insert(probes[i]);
+  });
+}
+
+BENCHMARK(StdSet_churn, "SkipList", "std::set", "remove+insert", 10000000) {
+  std::set<int> set(run.keys().begin(), run.keys().end());
+  auto probes = run.probes(run.size());
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    set.erase(probes[i]);
+    set.insert(probes[i]);
+  });
+}
@@ -0,0 +1,125 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/bench.hpp"
+#include "hash_table.hpp"
+#include "red_black_tree.hpp"
+#include "snapshot.hpp"
+#include "snapshot_view.hpp"
+
+// Cold start: rebuilding a container from its source data compared to loading
+// it from a snapshot held in memory, e.g. a mapped file.
+
+static const std::size_t MAX_TREE_SIZE = 100000;
+static const std::size_t MAX_TABLE_SIZE = 100000;
+
+template <typename Container>
+static std::string takeSnapshot(const Container& container) {
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  container.writeSnapshot(writer);
+  return ss.str();
+}
+
+static std::vector<std::string> toStrings(const std::vector<int>& keys) {
+  std::vector<std::string> strings;
+  strings.reserve(keys.size());
+  for (auto key : keys) strings.push_back(std::to_string(key));
+
+  return strings;
+}
+
+BENCHMARK(RedBlackTree_load_rebuild, "RedBlackTree", "RedBlackTree (rebuild)",
+          "load", MAX_TREE_SIZE) {
+  RedBlackTree<int> tree;
+
+  run.measure(1, [&](std::size_t) {
+    for (auto key : run.keys()) tree.insert(key);
+  });
+}
+
+BENCHMARK(RedBlackTree_load_snapshot, "RedBlackTree",
+          "RedBlackTree (snapshot)", "load", MAX_TREE_SIZE) {
+  RedBlackTree<int> source;
+  for (auto key : run.keys()) source.insert(key);
+  auto snapshot = takeSnapshot(source);
+  RedBlackTree<int> tree;
+
+  run.measure(1, [&](std::size_t) {
+    SnapshotReader reader(snapshot.data(), snapshot.size());
+    tree.readSnapshot(reader);
+  });
+}
+
+BENCHMARK(SortedSnapshotView_contains, "RedBlackTree", "SortedSnapshotView",
+          "contains", 10000000) {
+  std::vector<int> keys(run.keys());
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  writer.writeHeader(SnapshotKind::SORTED, sizeof(int));
+  writer.write(static_cast<std::uint64_t>(keys.size()));
+  for (auto key : keys) writer.write(key);
+  auto snapshot = ss.str();
+
+  SortedSnapshotView<int> view(snapshot.data(), snapshot.size());
+  auto probes = run.probes(run.size());
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(view.contains(probes[i]));
+  });
+}
+
+BENCHMARK(HashTable_load_rebuild, "HashTable", "HashTable (rebuild)", "load",
+          MAX_TABLE_SIZE) {
+  auto keys = toStrings(run.keys());
+  HashTable<int> table;
+
+  run.measure(1, [&](std::size_t) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      table.set(keys[i], static_cast<int>(i));
+    }
+  });
+}
+
+BENCHMARK(HashTable_load_snapshot, "HashTable", "HashTable (snapshot)", "load",
+          MAX_TABLE_SIZE) {
+  auto keys = toStrings(run.keys());
+  HashTable<int> source;
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    source.set(keys[i], static_cast<int>(i));
+  }
+  auto snapshot = takeSnapshot(source);
+  HashTable<int> table;
+
+  run.measure(1, [&](std::size_t) {
+    SnapshotReader reader(snapshot.data(), snapshot.size());
+    table.readSnapshot(reader);
+  });
+}
@@ -0,0 +1,57 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stack>
+#include "bench/bench.hpp"
+#include "stack.hpp"
+
+BENCHMARK(Stack_push, "Stack", "Stack", "push", 10000000) {
+  Stack<int> stack;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { stack.push(keys[i]); });
+}
+
+BENCHMARK(StdStack_push, "Stack", "std::stack", "push", 10000000) {
+  std::stack<int> stack;
+  auto& keys = run.keys();
+
+  run.measure(keys.size(), [&](std::size_t i) { stack.push(keys[i]); });
+}
+
+BENCHMARK(Stack_pop, "Stack", "Stack", "pop", 10000000) {
+  Stack<int> stack;
+  for (auto key : run.keys()) stack.push(key);
+
+  run.measure(run.size(),
+              [&](std::size_t) { bench::doNotOptimize(stack.pop()); });
+}
+
+BENCHMARK(StdStack_pop, "Stack", "std::stack", "pop", 10000000) {
+  std::stack<int> stack;
+  for (auto key : run.keys()) stack.push(key);
+
+  run.measure(run.size(), [&](std::size_t) {
+    bench::doNotOptimize(stack.top());
+    stack.pop();
+  });
+}
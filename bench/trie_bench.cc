@@ -0,0 +1,74 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <set>
+#include <string>
+#include <vector>
+#include "bench/bench.hpp"
+#include "trie.hpp"
+
+// Every TrieNode carries a HashTable of its children, so memory grows quickly.
+static const std::size_t MAX_TRIE_SIZE = 100000;
+
+static std::vector<std::string> toWords(const std::vector<int>& keys) {
+  std::vector<std::string> words;
+  words.reserve(keys.size());
+  for (auto key : keys) words.push_back(std::to_string(key));
+
+  return words;
+}
+
+BENCHMARK(Trie_addWord, "Trie", "Trie", "addWord", MAX_TRIE_SIZE) {
+  Trie trie;
+  auto words = toWords(run.keys());
+
+  run.measure(words.size(), [&](std::size_t i) { trie.addWord(words[i]); });
+}
+
+BENCHMARK(StdSet_addWord, "Trie", "std::set", "addWord", 10000000) {
+  std::set<std::string> set;
+  auto words = toWords(run.keys());
+
+  run.measure(words.size(), [&](std::size_t i) { set.insert(words[i]); });
+}
+
+BENCHMARK(Trie_doesWordExist, "Trie", "Trie", "doesWordExist",
+          MAX_TRIE_SIZE) {
+  Trie trie;
+  for (auto& word : toWords(run.keys())) trie.addWord(word);
+  auto probes = toWords(run.probes(run.size()));
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(trie.doesWordExist(probes[i]));
+  });
+}
+
+BENCHMARK(StdSet_doesWordExist, "Trie", "std::set", "doesWordExist",
+          10000000) {
+  auto words = toWords(run.keys());
+  std::set<std::string> set(words.begin(), words.end());
+  auto probes = toWords(run.probes(run.size()));
+
+  run.measure(probes.size(), [&](std::size_t i) {
+    bench::doNotOptimize(set.count(probes[i]));
+  });
+}
@@ -0,0 +1,173 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Needs C++20 coroutines, in older language modes this header is empty.
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "queue.hpp"
+
+// Runs resumed coroutines. AsyncQueue posts the consumers it wakes to an
+// executor instead of resuming them inline, so a producer never runs
+// consumer code on its own stack or thread.
+class AsyncExecutor {
+ public:
+  virtual ~AsyncExecutor() = default;
+
+  // May be called from any thread.
+  virtual void post(std::coroutine_handle<> handle) = 0;
+};
+
+// Executor that resumes coroutines on the thread calling run(). Any thread
+// may post to it.
+class EventLoop : public AsyncExecutor {
+ public:
+  void post(std::coroutine_handle<> handle) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.enqueue(handle);
+  }
+
+  // Resumes one posted coroutine. Returns false if none was ready.
+  bool runOne() {
+    std::coroutine_handle<> handle;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!ready_.tryDequeue(handle)) {
+        return false;
+      }
+    }
+
+    handle.resume();
+    return true;
+  }
+
+  // Resumes coroutines until none is ready, including the ones posted
+  // meanwhile. Returns how many were resumed.
+  std::size_t run() {
+    std::size_t count = 0;
+    while (runOne()) {
+      ++count;
+    }
+
+    return count;
+  }
+
+ private:
+  std::mutex mutex_;
+  Queue<std::coroutine_handle<>> ready_;
+};
+
+// Queue whose consumers are coroutines. co_await queue.dequeue() takes the
+// head right away if there is one, and otherwise suspends the coroutine
+// without blocking its thread. enqueue hands the value straight to the
+// longest waiting consumer and posts it to the executor. A suspended
+// consumer costs its coroutine frame and one slot in the waiter queue.
+template <typename T, typename Allocator = std::allocator<T>>
+class AsyncQueue {
+ public:
+  class DequeueAwaiter {
+   public:
+    explicit DequeueAwaiter(AsyncQueue& queue) : queue_(queue) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    // Does not suspend if a value can be taken right away.
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock(queue_.mutex_);
+      if (queue_.values_.tryDequeue(value_)) {
+        return false;
+      }
+
+      handle_ = handle;
+      queue_.waiters_.enqueue(this);
+      return true;
+    }
+
+    T await_resume() { return std::move(*value_); }
+
+   private:
+    friend class AsyncQueue;
+
+    AsyncQueue& queue_;
+    std::coroutine_handle<> handle_;
+    std::optional<T> value_;
+  };
+
+ public:
+  explicit AsyncQueue(AsyncExecutor& executor,
+                      const Allocator& allocator = Allocator())
+      : executor_(executor), values_(allocator) {}
+
+  AsyncQueue(const AsyncQueue&) = delete;
+  AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+  void enqueue(const T& value) { emplace(value); }
+
+  void enqueue(T&& value) { emplace(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    DequeueAwaiter* waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!waiters_.tryDequeue(waiter)) {
+        values_.emplace(std::forward<Args>(args)...);
+        return;
+      }
+
+      waiter->value_.emplace(std::forward<Args>(args)...);
+    }
+
+    executor_.post(waiter->handle_);
+  }
+
+  DequeueAwaiter dequeue() { return DequeueAwaiter(*this); }
+
+  // Values not taken yet.
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return values_.size();
+  }
+
+  bool isEmpty() const { return !size(); }
+
+  // Consumers suspended in dequeue.
+  std::size_t waiting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+  }
+
+ private:
+  AsyncExecutor& executor_;
+  mutable std::mutex mutex_;
+  Queue<T, NoStats, Allocator> values_;
+  Queue<DequeueAwaiter*> waiters_;
+};
+
+#endif  // defined(__cpp_impl_coroutine)
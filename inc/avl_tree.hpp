@@ -23,31 +23,48 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include "binary_search_tree.hpp"
 
-template <typename T>
-class AvlTree : public BinarySearchTree<T> {
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class AvlTree : public BinarySearchTree<T, Compare, Stats, Allocator> {
  public:
-  BinarySearchTreeNode<T>& insert(const T& value) {
-    auto& result = BinarySearchTree<T>::insert(value);
+  using tree_t = BinarySearchTree<T, Compare, Stats, Allocator>;
+  using node_t = typename tree_t::node_t;
 
-    auto currentNode = std::static_pointer_cast<BinarySearchTreeNode<T>>(
-        result.shared_from_this());
+ public:
+  explicit AvlTree(Compare compare = Compare(),
+                   const Allocator& allocator = Allocator())
+      : tree_t(compare, allocator) {}
+
+  node_t& insert(const T& value) {
+    return balanceFromInserted(tree_t::insert(value));
+  }
+
+  node_t& insert(T&& value) {
+    return balanceFromInserted(tree_t::insert(std::move(value)));
+  }
+
+  bool remove(const T& value) { throw MethodNotImplementedException(); }
+
+ private:
+  node_t& balanceFromInserted(node_t& result) {
+    // Walk up from the inserted node and balance every ancestor.
+    auto currentNode =
+        std::static_pointer_cast<node_t>(result.shared_from_this());
 
     while (currentNode) {
       balance(currentNode);
 
-      currentNode = std::static_pointer_cast<BinarySearchTreeNode<T>>(
-          currentNode->parent_.lock());
+      currentNode =
+          std::static_pointer_cast<node_t>(currentNode->parent_.lock());
     }
 
     return result;
   }
 
-  bool remove(const T& value) { throw MethodNotImplementedException(); }
-
- private:
-  void balance(std::shared_ptr<BinarySearchTreeNode<T>> node) {
+  void balance(std::shared_ptr<node_t> node) {
     // If balance factor is not OK then try to balance the node->
     if (node->balanceFactor() > 1) {
       // Left rotation.
@@ -70,7 +87,9 @@ class AvlTree : public BinarySearchTree<T> {
     }
   }
 
-  void rotateLeftLeft(std::shared_ptr<BinarySearchTreeNode<T>> rootNode) {
+  void rotateLeftLeft(std::shared_ptr<node_t> rootNode) {
+    this->stats_.countRotation();
+
     // Detach left node from root node
     auto leftNode = rootNode->left_;
     rootNode->setLeft(nullptr);
@@ -81,7 +100,7 @@ class AvlTree : public BinarySearchTree<T> {
       parent->setLeft(leftNode);
     } else if (rootNode == this->root_) {
       // If root node is root then make left node to be a new root.
-      this->root_ = std::static_pointer_cast<BinarySearchTreeNode<T>>(leftNode);
+      this->root_ = std::static_pointer_cast<node_t>(leftNode);
     }
 
     // If left node has a right child then detach it and
@@ -94,7 +113,9 @@ class AvlTree : public BinarySearchTree<T> {
     leftNode->setRight(rootNode);
   }
 
-  void rotateLeftRight(std::shared_ptr<BinarySearchTreeNode<T>> rootNode) {
+  void rotateLeftRight(std::shared_ptr<node_t> rootNode) {
+    this->stats_.countRotation();
+
     // Detach left node from rootNode since it is going to be replaced.
     auto leftNode = rootNode->left_;
     rootNode->setLeft(nullptr);
@@ -119,7 +140,9 @@ class AvlTree : public BinarySearchTree<T> {
     rotateLeftLeft(rootNode);
   }
 
-  void rotateRightLeft(std::shared_ptr<BinarySearchTreeNode<T>> rootNode) {
+  void rotateRightLeft(std::shared_ptr<node_t> rootNode) {
+    this->stats_.countRotation();
+
     // Detach right node from rootNode since it is going to be replaced.
     auto rightNode = rootNode->right_;
     rootNode->setRight(nullptr);
@@ -143,7 +166,9 @@ class AvlTree : public BinarySearchTree<T> {
     rotateRightRight(rootNode);
   }
 
-  void rotateRightRight(std::shared_ptr<BinarySearchTreeNode<T>> rootNode) {
+  void rotateRightRight(std::shared_ptr<node_t> rootNode) {
+    this->stats_.countRotation();
+
     // Detach right node from root node
     auto rightNode = rootNode->right_;
     rootNode->setRight(nullptr);
@@ -154,8 +179,7 @@ class AvlTree : public BinarySearchTree<T> {
       parent->setRight(rightNode);
     } else if (rootNode == this->root_) {
       // If root node is root then make right node to be a new root.
-      this->root_ =
-          std::static_pointer_cast<BinarySearchTreeNode<T>>(rightNode);
+      this->root_ = std::static_pointer_cast<node_t>(rightNode);
     }
 
     // If right node has a left child then detach it and
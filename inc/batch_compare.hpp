@@ -0,0 +1,344 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+template <typename T>
+struct DefaultCompare;
+
+// Batched comparisons over contiguous spans, one policy call per element.
+// Used as is for every policy, and as the fallback of the vectorized
+// specializations below.
+template <typename T, typename Compare>
+struct ScalarBatchCompare {
+  static void compareMany(const Compare& compare, const T& key,
+                          const T* values, std::size_t count, int* results) {
+    for (std::size_t index = 0; index < count; ++index) {
+      results[index] = compare(values[index], key);
+    }
+  }
+
+  static std::size_t minIndex(const Compare& compare, const T* values,
+                              std::size_t count) {
+    std::size_t best = 0;
+    for (std::size_t index = 1; index < count; ++index) {
+      if (compare(values[index], values[best]) < 0) {
+        best = index;
+      }
+    }
+
+    return best;
+  }
+
+  // Index of the first value equal to the given one. The value must be in
+  // the span.
+  static std::size_t firstIndexOf(const T* values, T value) {
+    std::size_t index = 0;
+    while (!(values[index] == value)) {
+      ++index;
+    }
+
+    return index;
+  }
+
+  // Finishes a vectorized minIndex given the lanes of the vector minimum and
+  // the position where the vectorized part stopped. Falls back to the scalar
+  // version when nothing was vectorized or the span holds a NaN.
+  static std::size_t finishMinIndex(const Compare& compare, const T* values,
+                                    std::size_t count, const T* lanes,
+                                    std::size_t laneCount, std::size_t index,
+                                    bool unordered) {
+    if (!laneCount) {
+      return minIndex(compare, values, count);
+    }
+
+    T minimum = lanes[0];
+    for (std::size_t lane = 1; lane < laneCount; ++lane) {
+      if (lanes[lane] < minimum) minimum = lanes[lane];
+    }
+    for (; index < count && !unordered; ++index) {
+      unordered = values[index] != values[index];
+      if (values[index] < minimum) minimum = values[index];
+    }
+
+    if (unordered) {
+      return minIndex(compare, values, count);
+    }
+
+    return firstIndexOf(values, minimum);
+  }
+};
+
+template <typename T, typename Compare>
+struct BatchCompare : ScalarBatchCompare<T, Compare> {};
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// The vectorized versions give the same results as DefaultCompare element by
+// element, which for a value v and a key k is
+//
+//   v == k ? 0 : (v < k ? -1 : 1),
+//
+// computed from the comparison masks (0 or -1) as 1 + eq + 2 * lt. A NaN
+// compares as greater than everything and minIndex never moves away from
+// one, which SIMD min instructions do not model, so spans holding a NaN are
+// handed to the scalar version.
+
+template <>
+struct BatchCompare<int, DefaultCompare<int>>
+    : ScalarBatchCompare<int, DefaultCompare<int>> {
+  static void compareMany(const DefaultCompare<int>& compare, int key,
+                          const int* values, std::size_t count, int* results) {
+    std::size_t index = 0;
+
+#if defined(__AVX2__)
+    const __m256i keys = _mm256_set1_epi32(key);
+    const __m256i ones = _mm256_set1_epi32(1);
+    for (; index + 8 <= count; index += 8) {
+      auto value = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(values + index));
+      auto lt = _mm256_cmpgt_epi32(keys, value);
+      auto eq = _mm256_cmpeq_epi32(value, keys);
+      auto result = _mm256_add_epi32(
+          ones, _mm256_add_epi32(eq, _mm256_add_epi32(lt, lt)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + index), result);
+    }
+#else
+    const __m128i keys = _mm_set1_epi32(key);
+    const __m128i ones = _mm_set1_epi32(1);
+    for (; index + 4 <= count; index += 4) {
+      auto value =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + index));
+      auto lt = _mm_cmplt_epi32(value, keys);
+      auto eq = _mm_cmpeq_epi32(value, keys);
+      auto result =
+          _mm_add_epi32(ones, _mm_add_epi32(eq, _mm_add_epi32(lt, lt)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(results + index), result);
+    }
+#endif
+
+    ScalarBatchCompare::compareMany(compare, key, values + index,
+                                    count - index, results + index);
+  }
+
+  static std::size_t minIndex(const DefaultCompare<int>& compare,
+                              const int* values, std::size_t count) {
+    int lanes[8];
+    std::size_t laneCount = 0;
+    std::size_t index = 0;
+
+#if defined(__AVX2__)
+    if (count >= 8) {
+      auto best =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+      for (index = 8; index + 8 <= count; index += 8) {
+        best = _mm256_min_epi32(
+            best, _mm256_loadu_si256(
+                      reinterpret_cast<const __m256i*>(values + index)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), best);
+      laneCount = 8;
+    }
+#else
+    if (count >= 4) {
+      auto best = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+      for (index = 4; index + 4 <= count; index += 4) {
+        auto value =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + index));
+        // SSE2 has no 32 bit min, so select with the comparison mask.
+        auto less = _mm_cmplt_epi32(value, best);
+        best = _mm_or_si128(_mm_and_si128(less, value),
+                            _mm_andnot_si128(less, best));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), best);
+      laneCount = 4;
+    }
+#endif
+
+    return finishMinIndex(compare, values, count, lanes, laneCount, index,
+                          false);
+  }
+};
+
+template <>
+struct BatchCompare<float, DefaultCompare<float>>
+    : ScalarBatchCompare<float, DefaultCompare<float>> {
+  static void compareMany(const DefaultCompare<float>& compare, float key,
+                          const float* values, std::size_t count,
+                          int* results) {
+    std::size_t index = 0;
+
+#if defined(__AVX2__)
+    const __m256 keys = _mm256_set1_ps(key);
+    const __m256i ones = _mm256_set1_epi32(1);
+    for (; index + 8 <= count; index += 8) {
+      auto value = _mm256_loadu_ps(values + index);
+      auto lt = _mm256_castps_si256(_mm256_cmp_ps(value, keys, _CMP_LT_OQ));
+      auto eq = _mm256_castps_si256(_mm256_cmp_ps(value, keys, _CMP_EQ_OQ));
+      auto result = _mm256_add_epi32(
+          ones, _mm256_add_epi32(eq, _mm256_add_epi32(lt, lt)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + index), result);
+    }
+#else
+    const __m128 keys = _mm_set1_ps(key);
+    const __m128i ones = _mm_set1_epi32(1);
+    for (; index + 4 <= count; index += 4) {
+      auto value = _mm_loadu_ps(values + index);
+      auto lt = _mm_castps_si128(_mm_cmplt_ps(value, keys));
+      auto eq = _mm_castps_si128(_mm_cmpeq_ps(value, keys));
+      auto result =
+          _mm_add_epi32(ones, _mm_add_epi32(eq, _mm_add_epi32(lt, lt)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(results + index), result);
+    }
+#endif
+
+    ScalarBatchCompare::compareMany(compare, key, values + index,
+                                    count - index, results + index);
+  }
+
+  static std::size_t minIndex(const DefaultCompare<float>& compare,
+                              const float* values, std::size_t count) {
+    float lanes[8];
+    std::size_t laneCount = 0;
+    std::size_t index = 0;
+    bool unordered = false;
+
+#if defined(__AVX2__)
+    if (count >= 8) {
+      auto best = _mm256_loadu_ps(values);
+      auto nan = _mm256_cmp_ps(best, best, _CMP_UNORD_Q);
+      for (index = 8; index + 8 <= count; index += 8) {
+        auto value = _mm256_loadu_ps(values + index);
+        nan = _mm256_or_ps(nan, _mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+        best = _mm256_min_ps(best, value);
+      }
+      _mm256_storeu_ps(lanes, best);
+      laneCount = 8;
+      unordered = _mm256_movemask_ps(nan) != 0;
+    }
+#else
+    if (count >= 4) {
+      auto best = _mm_loadu_ps(values);
+      auto nan = _mm_cmpunord_ps(best, best);
+      for (index = 4; index + 4 <= count; index += 4) {
+        auto value = _mm_loadu_ps(values + index);
+        nan = _mm_or_ps(nan, _mm_cmpunord_ps(value, value));
+        best = _mm_min_ps(best, value);
+      }
+      _mm_storeu_ps(lanes, best);
+      laneCount = 4;
+      unordered = _mm_movemask_ps(nan) != 0;
+    }
+#endif
+
+    return finishMinIndex(compare, values, count, lanes, laneCount, index,
+                          unordered);
+  }
+};
+
+template <>
+struct BatchCompare<double, DefaultCompare<double>>
+    : ScalarBatchCompare<double, DefaultCompare<double>> {
+  static void compareMany(const DefaultCompare<double>& compare, double key,
+                          const double* values, std::size_t count,
+                          int* results) {
+    std::size_t index = 0;
+
+    // Doubles give 64 bit masks, so the results are spread from the mask
+    // bits instead of narrowing the vectors.
+#if defined(__AVX2__)
+    const __m256d keys = _mm256_set1_pd(key);
+    for (; index + 4 <= count; index += 4) {
+      auto value = _mm256_loadu_pd(values + index);
+      auto lt = _mm256_movemask_pd(_mm256_cmp_pd(value, keys, _CMP_LT_OQ));
+      auto eq = _mm256_movemask_pd(_mm256_cmp_pd(value, keys, _CMP_EQ_OQ));
+      spreadResults(lt, eq, 4, results + index);
+    }
+#else
+    const __m128d keys = _mm_set1_pd(key);
+    for (; index + 2 <= count; index += 2) {
+      auto value = _mm_loadu_pd(values + index);
+      auto lt = _mm_movemask_pd(_mm_cmplt_pd(value, keys));
+      auto eq = _mm_movemask_pd(_mm_cmpeq_pd(value, keys));
+      spreadResults(lt, eq, 2, results + index);
+    }
+#endif
+
+    ScalarBatchCompare::compareMany(compare, key, values + index,
+                                    count - index, results + index);
+  }
+
+  static std::size_t minIndex(const DefaultCompare<double>& compare,
+                              const double* values, std::size_t count) {
+    double lanes[4];
+    std::size_t laneCount = 0;
+    std::size_t index = 0;
+    bool unordered = false;
+
+#if defined(__AVX2__)
+    if (count >= 4) {
+      auto best = _mm256_loadu_pd(values);
+      auto nan = _mm256_cmp_pd(best, best, _CMP_UNORD_Q);
+      for (index = 4; index + 4 <= count; index += 4) {
+        auto value = _mm256_loadu_pd(values + index);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(value, value, _CMP_UNORD_Q));
+        best = _mm256_min_pd(best, value);
+      }
+      _mm256_storeu_pd(lanes, best);
+      laneCount = 4;
+      unordered = _mm256_movemask_pd(nan) != 0;
+    }
+#else
+    if (count >= 2) {
+      auto best = _mm_loadu_pd(values);
+      auto nan = _mm_cmpunord_pd(best, best);
+      for (index = 2; index + 2 <= count; index += 2) {
+        auto value = _mm_loadu_pd(values + index);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(value, value));
+        best = _mm_min_pd(best, value);
+      }
+      _mm_storeu_pd(lanes, best);
+      laneCount = 2;
+      unordered = _mm_movemask_pd(nan) != 0;
+    }
+#endif
+
+    return finishMinIndex(compare, values, count, lanes, laneCount, index,
+                          unordered);
+  }
+
+ private:
+  static void spreadResults(int lt, int eq, int lanes, int* results) {
+    for (int lane = 0; lane < lanes; ++lane) {
+      results[lane] = 1 - ((eq >> lane) & 1) - 2 * ((lt >> lane) & 1);
+    }
+  }
+};
+
+#endif  // __AVX2__ || __SSE2__
@@ -22,28 +22,136 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <string>
 #include "binary_search_tree_node.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
 
-template <typename T>
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
 class BinarySearchTree {
  public:
-  explicit BinarySearchTree(typename Comparator<T>::compare_func_t
-                                nodeValueCompareFunction = nullptr) {
-    root_ = std::make_shared<BinarySearchTreeNode<T>>(nodeValueCompareFunction);
+  using node_t = BinarySearchTreeNode<T, Compare, Stats, Allocator>;
+
+ public:
+  explicit BinarySearchTree(Compare nodeValueCompareFunction = Compare(),
+                            const Allocator& allocator = Allocator()) {
+    root_ = std::allocate_shared<node_t>(allocator, nodeValueCompareFunction,
+                                         &stats_, allocator);
+  }
+
+  // Copies would share their nodes.
+  BinarySearchTree(const BinarySearchTree&) = delete;
+  BinarySearchTree& operator=(const BinarySearchTree&) = delete;
+
+  // The nodes report into the stats of the tree that owns them, so they are
+  // pointed at this tree. other is left empty.
+  BinarySearchTree(BinarySearchTree&& other)
+      : root_(std::allocate_shared<node_t>(
+            other.root_->allocator_, other.root_->value_comparator_.policy(),
+            &stats_, other.root_->allocator_)) {
+    swap(other);
+  }
+
+  BinarySearchTree& operator=(BinarySearchTree&& other) {
+    swap(other);
+    return *this;
   }
 
-  BinarySearchTreeNode<T>& insert(const T& value) {
+  void swap(BinarySearchTree& other) {
+    using std::swap;
+    swap(root_, other.root_);
+    swap(stats_, other.stats_);
+    root_->reportTo(&stats_);
+    other.root_->reportTo(&other.stats_);
+  }
+
+  node_t& insert(const T& value) {
     return root_->insert(value);
   }
 
+  node_t& insert(T&& value) { return root_->insert(std::move(value)); }
+
   bool contains(const T& value) const { return root_->contains(value); }
 
   bool remove(const T& value) { return root_->remove(value); }
 
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return root_->write(writer);
+  }
+
   std::string toString() const { return root_->toString(); }
 
+  // Writes the values in sorted order as a SORTED snapshot.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    std::uint64_t count = 0;
+    root_->forEachInOrder([&](const T&) { ++count; });
+
+    writer.writeHeader(SnapshotKind::SORTED, SnapshotCodec<T>::fixed_size);
+    writer.write(count);
+    root_->forEachInOrder([&](const T& value) { writer.write(value); });
+  }
+
+  // Replaces the content of the tree with the values of a SORTED snapshot.
+  // The tree is built perfectly balanced in one pass over the values, so no
+  // comparisons or rotations are needed besides checking the order. The tree
+  // is left unchanged if the snapshot is malformed.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SORTED, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    auto compare = root_->value_comparator_.policy();
+    auto allocator = root_->allocator_;
+    if (!count) {
+      root_ = std::allocate_shared<node_t>(allocator, compare, &stats_,
+                                           allocator);
+      return;
+    }
+
+    const T* previous = nullptr;
+    root_ = buildBalanced(reader, count, compare, allocator, &previous);
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Builds a subtree out of the next count values, which are in order.
+  std::shared_ptr<node_t> buildBalanced(SnapshotReader& reader,
+                                        std::uint64_t count,
+                                        const Compare& compare,
+                                        const Allocator& allocator,
+                                        const T** previous) {
+    if (!count) {
+      return nullptr;
+    }
+
+    auto leftCount = count / 2;
+    auto left = buildBalanced(reader, leftCount, compare, allocator, previous);
+
+    stats_.countAllocation();
+    auto node = std::allocate_shared<node_t>(allocator, reader.read<T>(),
+                                             compare, &stats_, allocator);
+    if (*previous &&
+        !node->value_comparator_.lessThan(**previous, node->value_)) {
+      throw SnapshotError("snapshot values are not sorted");
+    }
+    *previous = &node->value_;
+
+    auto right = buildBalanced(reader, count - leftCount - 1, compare,
+                               allocator, previous);
+    node->setLeft(left);
+    node->setRight(right);
+
+    return node;
+  }
+
  public:
-  std::shared_ptr<BinarySearchTreeNode<T>> root_;
+  std::shared_ptr<node_t> root_;
+
+ protected:
+  Stats stats_;
 };
@@ -23,101 +23,76 @@
 #pragma once
 
 #include <memory>
+#include <utility>
+#include <vector>
 #include "binary_tree_node.hpp"
 #include "comparator.hpp"
+#include "stats.hpp"
 
-template <typename T>
-class BinarySearchTreeNode : public BinaryTreeNode<T> {
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class BinarySearchTreeNode : public BinaryTreeNode<T>,
+                             private CachedKey<T, Compare>,
+                             private StatsHandle<Stats> {
  public:
-  explicit BinarySearchTreeNode(
-      typename Comparator<T>::compare_func_t compare = nullptr)
+  using cached_key_t = CachedKey<T, Compare>;
+  using stats_handle_t = StatsHandle<Stats>;
+  using key_t = typename Comparator<T, Compare>::key_type;
+
+ public:
+  explicit BinarySearchTreeNode(Compare compare = Compare(),
+                                Stats *stats = nullptr,
+                                const Allocator &allocator = Allocator())
       : BinaryTreeNode<T>(),
-        compare_(compare),
-        value_comparator_(Comparator<T>(compare)) {}
+        stats_handle_t(stats),
+        value_comparator_(compare),
+        allocator_(allocator) {}
 
-  BinarySearchTreeNode(const T &value,
-                       typename Comparator<T>::compare_func_t compare = nullptr)
+  BinarySearchTreeNode(const T &value, Compare compare = Compare(),
+                       Stats *stats = nullptr,
+                       const Allocator &allocator = Allocator())
       : BinaryTreeNode<T>(value),
-        compare_(compare),
-        value_comparator_(Comparator<T>(compare)) {}
-
-  BinarySearchTreeNode &insert(const T &value) {
-    if (!this->valid_) {
-      this->setValue(value);
-      return *this;
-    }
-
-    if (this->value_comparator_.lessThan(value, this->value_)) {
-      // Insert to the left.
-      auto left = this->left_;
-      if (left) {
-        return std::static_pointer_cast<BinarySearchTreeNode>(left)->insert(
-            value);
-      }
-
-      auto newNode = std::make_shared<BinarySearchTreeNode>(value, compare_);
-      this->setLeft(newNode);
-
-      return *newNode;
-    }
-
-    if (this->value_comparator_.greaterThan(value, this->value_)) {
-      // Insert to the right.
-      auto right = this->right_;
-      if (right) {
-        return std::static_pointer_cast<BinarySearchTreeNode>(right)->insert(
-            value);
-      }
-
-      auto newNode = std::make_shared<BinarySearchTreeNode>(value, compare_);
-      this->setRight(newNode);
-
-      return *newNode;
-    }
-
-    return *this;
+        cached_key_t(compare, this->value_),
+        stats_handle_t(stats),
+        value_comparator_(compare),
+        allocator_(allocator) {}
+
+  BinarySearchTreeNode(T &&value, Compare compare = Compare(),
+                       Stats *stats = nullptr,
+                       const Allocator &allocator = Allocator())
+      : BinaryTreeNode<T>(std::move(value)),
+        cached_key_t(compare, this->value_),
+        stats_handle_t(stats),
+        value_comparator_(compare),
+        allocator_(allocator) {}
+
+  // Takes over a key already projected from value.
+  template <typename Value>
+  BinarySearchTreeNode(Value &&value, cached_key_t key, Compare compare,
+                       Stats *stats, const Allocator &allocator)
+      : BinaryTreeNode<T>(std::forward<Value>(value)),
+        cached_key_t(std::move(key)),
+        stats_handle_t(stats),
+        value_comparator_(compare),
+        allocator_(allocator) {}
+
+  // The key the node is ordered by: the cached projection of its value for
+  // ProjectionCompare, the value itself otherwise.
+  const key_t &key() const { return this->cachedKey(this->value_); }
+
+  BinarySearchTreeNode &insert(const T &value) { return insertValue(value); }
+
+  BinarySearchTreeNode &insert(T &&value) {
+    return insertValue(std::move(value));
   }
 
   BinarySearchTreeNode *find(const T &value) {
-    // Check the root.
-    if (this->value_comparator_.equal(this->value_, value)) {
-      return this;
-    }
-
-    auto left = this->left_;
-    if (this->value_comparator_.lessThan(value, this->value_) && left) {
-      // Check left nodes.
-      return std::static_pointer_cast<BinarySearchTreeNode>(left)->find(value);
-    }
-
-    auto right = this->right_;
-    if (this->value_comparator_.greaterThan(value, this->value_) && right) {
-      // Check right nodes.
-      return std::static_pointer_cast<BinarySearchTreeNode>(right)->find(value);
-    }
-
-    return nullptr;
+    return const_cast<BinarySearchTreeNode *>(
+        findKey(value_comparator_.key(value)));
   }
 
   const BinarySearchTreeNode *find(const T &value) const {
-    // Check the root.
-    if (this->value_comparator_.equal(this->value_, value)) {
-      return this;
-    }
-
-    auto left = this->left_;
-    if (this->value_comparator_.lessThan(value, this->value_) && left) {
-      // Check left nodes.
-      return std::static_pointer_cast<BinarySearchTreeNode>(left)->find(value);
-    }
-
-    auto right = this->right_;
-    if (this->value_comparator_.greaterThan(value, this->value_) && right) {
-      // Check right nodes.
-      return std::static_pointer_cast<BinarySearchTreeNode>(right)->find(value);
-    }
-
-    return nullptr;
+    return findKey(value_comparator_.key(value));
   }
 
   bool contains(const T &value) const { return !!find(value); }
@@ -152,14 +127,18 @@ class BinarySearchTreeNode : public BinaryTreeNode<T> {
       if (!this->node_comparator_.equal(&nextBiggerNode,
                                         nodeToRemove->right_.get())) {
         auto value = nextBiggerNode.value_;
+        cached_key_t key = nextBiggerNode;
         remove(value);
-        nodeToRemove->setValue(value);
+        nodeToRemove->setValue(std::move(value));
+        nodeToRemove->cachedKeyRef() = std::move(key);
       } else {
         // In case if next right value is the next bigger one and it doesn't
         // have left child then just replace node that is going to be deleted
         // with the right node.
-        nodeToRemove->setValue(nodeToRemove->right_->value_);
-        nodeToRemove->setRight(nodeToRemove->right_->right_);
+        auto right = nodeToRemove->right_;
+        nodeToRemove->copyValue(
+            static_cast<const BinarySearchTreeNode &>(*right));
+        nodeToRemove->setRight(right->right_);
       }
     } else {
       // Node has only one child.
@@ -172,6 +151,8 @@ class BinarySearchTreeNode : public BinaryTreeNode<T> {
         parent->replaceChild(nodeToRemove, childNode);
       } else {
         BinaryTreeNode<T>::copyNode(*childNode, nodeToRemove);
+        nodeToRemove->cachedKeyRef() =
+            static_cast<const BinarySearchTreeNode &>(*childNode);
       }
     }
 
@@ -199,9 +180,140 @@ class BinarySearchTreeNode : public BinaryTreeNode<T> {
         ->findMin();
   }
 
+  // Makes every node of the subtree report into stats, for a tree that has
+  // taken the nodes over from another one.
+  void reportTo(Stats *stats) {
+    if (!Stats::enabled) {
+      return;
+    }
+
+    std::vector<BinarySearchTreeNode *> pending(1, this);
+    while (!pending.empty()) {
+      auto node = pending.back();
+      pending.pop_back();
+      node->statsHandleRef() = stats_handle_t(stats);
+
+      if (node->left_) {
+        pending.push_back(
+            static_cast<BinarySearchTreeNode *>(node->left_.get()));
+      }
+      if (node->right_) {
+        pending.push_back(
+            static_cast<BinarySearchTreeNode *>(node->right_.get()));
+      }
+    }
+  }
+
+ private:
+  cached_key_t &cachedKeyRef() { return *this; }
+
+  stats_handle_t &statsHandleRef() { return *this; }
+
+  const stats_handle_t &statsHandle() const { return *this; }
+
+  void copyValue(const BinarySearchTreeNode &node) {
+    this->setValue(node.value_);
+    cachedKeyRef() = node;
+  }
+
+  const BinarySearchTreeNode *findKey(const key_t &key) const {
+    statsHandle().countNodeVisit();
+
+    // Check the root.
+    if (equal(this->key(), key)) {
+      return this;
+    }
+
+    auto left = this->left_;
+    if (lessThan(key, this->key()) && left) {
+      // Check left nodes.
+      return std::static_pointer_cast<BinarySearchTreeNode>(left)->findKey(key);
+    }
+
+    auto right = this->right_;
+    if (greaterThan(key, this->key()) && right) {
+      // Check right nodes.
+      return std::static_pointer_cast<BinarySearchTreeNode>(right)->findKey(
+          key);
+    }
+
+    return nullptr;
+  }
+
+  // The key of the value is projected once here and handed down the tree to
+  // the new node.
+  template <typename Value>
+  BinarySearchTreeNode &insertValue(Value &&value) {
+    cached_key_t key(value_comparator_.policy(), value);
+    return insertValue(std::forward<Value>(value), &key);
+  }
+
+  template <typename Value>
+  BinarySearchTreeNode &insertValue(Value &&value, cached_key_t *key) {
+    if (!this->valid_) {
+      this->setValue(std::forward<Value>(value));
+      cachedKeyRef() = std::move(*key);
+      return *this;
+    }
+
+    if (lessThan(key->cachedKey(value), this->key())) {
+      // Insert to the left.
+      auto left = this->left_;
+      if (left) {
+        return std::static_pointer_cast<BinarySearchTreeNode>(left)
+            ->insertValue(std::forward<Value>(value), key);
+      }
+
+      auto newNode = makeNode(std::forward<Value>(value), key);
+      this->setLeft(newNode);
+
+      return *newNode;
+    }
+
+    if (greaterThan(key->cachedKey(value), this->key())) {
+      // Insert to the right.
+      auto right = this->right_;
+      if (right) {
+        return std::static_pointer_cast<BinarySearchTreeNode>(right)
+            ->insertValue(std::forward<Value>(value), key);
+      }
+
+      auto newNode = makeNode(std::forward<Value>(value), key);
+      this->setRight(newNode);
+
+      return *newNode;
+    }
+
+    return *this;
+  }
+
+  template <typename Value>
+  std::shared_ptr<BinarySearchTreeNode> makeNode(Value &&value,
+                                                 cached_key_t *key) {
+    statsHandle().countAllocation();
+    return std::allocate_shared<BinarySearchTreeNode>(
+        allocator_, std::forward<Value>(value), std::move(*key),
+        value_comparator_.policy(), statsHandle().get(), allocator_);
+  }
+
+  bool equal(const key_t &a, const key_t &b) const {
+    statsHandle().countComparison();
+    return value_comparator_.compareKeys(a, b) == 0;
+  }
+
+  bool lessThan(const key_t &a, const key_t &b) const {
+    statsHandle().countComparison();
+    return value_comparator_.compareKeys(a, b) < 0;
+  }
+
+  bool greaterThan(const key_t &a, const key_t &b) const {
+    statsHandle().countComparison();
+    return value_comparator_.compareKeys(a, b) > 0;
+  }
+
  public:
-  typename Comparator<T>::compare_func_t compare_;
-  Comparator<T> value_comparator_;
+  Comparator<T, Compare> value_comparator_;
+  Allocator allocator_;
 
  public:
   class ItemNotFoundException : public std::exception {};
@@ -25,8 +25,10 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "hash_table.hpp"
+#include "string_writer.hpp"
 
 template <typename T>
 class BinaryTreeNode : public std::enable_shared_from_this<BinaryTreeNode<T>> {
@@ -46,6 +48,14 @@ class BinaryTreeNode : public std::enable_shared_from_this<BinaryTreeNode<T>> {
         valid_(true),
         node_comparator_(Comparator<const BinaryTreeNode *>()) {}
 
+  explicit BinaryTreeNode(T &&value)
+      : left_(nullptr),
+        right_(nullptr),
+        parent_(),
+        value_(std::move(value)),
+        valid_(true),
+        node_comparator_(Comparator<const BinaryTreeNode *>()) {}
+
   int leftHeight() const {
     auto left = left_;
     return left ? left->height() + 1 : 0;
@@ -96,9 +106,17 @@ class BinaryTreeNode : public std::enable_shared_from_this<BinaryTreeNode<T>> {
     return *this;
   }
 
+  BinaryTreeNode &setValue(T &&value) {
+    value_ = std::move(value);
+    valid_ = true;
+
+    return *this;
+  }
+
   BinaryTreeNode &setLeft(std::shared_ptr<BinaryTreeNode> node) {
-    // Reset parent for left node since it is going to be detached.
-    if (left_) {
+    // Reset parent for left node since it is going to be detached, unless it
+    // has already been attached somewhere else.
+    if (left_ && left_->parent_.lock().get() == this) {
       left_->parent_.reset();
     }
 
@@ -114,8 +132,9 @@ class BinaryTreeNode : public std::enable_shared_from_this<BinaryTreeNode<T>> {
   }
 
   BinaryTreeNode &setRight(std::shared_ptr<BinaryTreeNode> node) {
-    // Reset parent for right node since it is going to be detached.
-    if (right_) {
+    // Reset parent for right node since it is going to be detached, unless it
+    // has already been attached somewhere else.
+    if (right_ && right_->parent_.lock().get() == this) {
       right_->parent_.reset();
     }
 
@@ -195,16 +214,43 @@ class BinaryTreeNode : public std::enable_shared_from_this<BinaryTreeNode<T>> {
     return traverse;
   }
 
+  // Writes the values in order separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer &write(Writer &writer) const {
+    bool first = true;
+    forEachInOrder([&](const T &value) {
+      if (!first) {
+        writer.write(',');
+      }
+
+      writer.write(value);
+      first = false;
+    });
+
+    return writer;
+  }
+
+  // Calls visit with every value of the subtree in order, without copying
+  // them into a vector like traverseInOrder does.
+  template <typename Visit>
+  void forEachInOrder(Visit &&visit) const {
+    if (left_) {
+      left_->forEachInOrder(visit);
+    }
+
+    if (valid_) {
+      visit(value_);
+    }
+
+    if (right_) {
+      right_->forEachInOrder(visit);
+    }
+  }
+
   std::string toString() const {
-    std::vector<T> nodes = traverseInOrder();
-    std::string ret = std::accumulate(nodes.begin(), nodes.end(), std::string(),
-                                      [](const std::string &a, const T &b) {
-                                        std::stringstream ss;
-                                        ss << a << "," << b;
-                                        return ss.str();
-                                      });
-
-    return ret.length() ? ret.substr(1) : ret;
+    StringWriter writer;
+    return write(writer).release();
   }
 
  public:
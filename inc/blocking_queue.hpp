@@ -0,0 +1,254 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "queue.hpp"
+#include "stats.hpp"
+
+// Queue shared between threads whose consumers sleep while it is empty and
+// whose producers sleep while it is full, if it has a capacity. Sleepers are
+// counted, so a side only signals the other when someone actually waits.
+// dequeueBulk drains everything ready up to a limit per wakeup. close()
+// wakes every waiter and makes the queue refuse new values, consumers still
+// get the ones left.
+template <typename T, typename Allocator = std::allocator<T>>
+class BlockingQueue {
+ public:
+  // A capacity of 0 leaves the queue unbounded.
+  explicit BlockingQueue(std::size_t capacity = 0,
+                         const Allocator& allocator = Allocator())
+      : queue_(allocator),
+        capacity_(capacity),
+        closed_(false),
+        waiting_consumers_(0),
+        waiting_producers_(0) {}
+
+  BlockingQueue(const BlockingQueue&) = delete;
+  BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+  // Waits for room. Returns false if the queue is closed.
+  bool enqueue(const T& value) { return emplace(value); }
+
+  bool enqueue(T&& value) { return emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait(not_full_, waiting_producers_, lock, [this]() { return hasRoom(); });
+    if (closed_) {
+      return false;
+    }
+
+    queue_.emplace(std::forward<Args>(args)...);
+    wake(not_empty_, waiting_consumers_, lock, 1);
+    return true;
+  }
+
+  // Returns false instead of waiting if the queue is full or closed.
+  bool tryEnqueue(const T& value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_ || isFull()) {
+      return false;
+    }
+
+    queue_.enqueue(value);
+    wake(not_empty_, waiting_consumers_, lock, 1);
+    return true;
+  }
+
+  // Enqueues the values in order, as many at a time as there is room for.
+  // Returns how many were enqueued, fewer than count only if the queue is
+  // closed meanwhile.
+  std::size_t enqueueBulk(const T* values, std::size_t count) {
+    std::size_t enqueued = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (enqueued < count) {
+      wait(not_full_, waiting_producers_, lock, [this]() { return hasRoom(); });
+      if (closed_) {
+        break;
+      }
+
+      auto batch = count - enqueued;
+      if (capacity_) {
+        batch = std::min(batch, capacity_ - queue_.size());
+      }
+
+      queue_.enqueueBulk(values + enqueued, batch);
+      enqueued += batch;
+      wake(not_empty_, waiting_consumers_, lock, batch);
+      lock.lock();
+    }
+
+    return enqueued;
+  }
+
+  // Waits for a value and moves it into value. Returns false once the queue
+  // is closed and empty.
+  bool dequeue(T& value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait(not_empty_, waiting_consumers_, lock, [this]() { return hasValue(); });
+    return take(value, lock);
+  }
+
+  // Like dequeue, but gives up after timeout.
+  template <typename Rep, typename Period>
+  bool dequeueFor(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitFor(not_empty_, waiting_consumers_, lock, timeout,
+            [this]() { return hasValue(); });
+    return take(value, lock);
+  }
+
+  // Returns false instead of waiting if the queue is empty.
+  bool tryDequeue(T& value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return take(value, lock);
+  }
+
+  // Waits for at least one value and moves up to count of them into values.
+  // Returns how many were moved, 0 once the queue is closed and empty.
+  std::size_t dequeueBulk(T* values, std::size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait(not_empty_, waiting_consumers_, lock, [this]() { return hasValue(); });
+    return takeBulk(values, count, lock);
+  }
+
+  // Like dequeueBulk, but gives up after timeout and returns 0.
+  template <typename Rep, typename Period>
+  std::size_t dequeueBulkFor(
+      T* values, std::size_t count,
+      const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitFor(not_empty_, waiting_consumers_, lock, timeout,
+            [this]() { return hasValue(); });
+    return takeBulk(values, count, lock);
+  }
+
+  // Refuses new values and wakes every waiter.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  bool isClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  bool isEmpty() const { return !size(); }
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  bool isFull() const { return capacity_ && queue_.size() >= capacity_; }
+
+  bool hasRoom() const { return closed_ || !isFull(); }
+
+  bool hasValue() const { return closed_ || !queue_.isEmpty(); }
+
+  template <typename Ready>
+  static void wait(std::condition_variable& condition, std::size_t& waiters,
+                   std::unique_lock<std::mutex>& lock, Ready ready) {
+    if (ready()) {
+      return;
+    }
+
+    ++waiters;
+    condition.wait(lock, ready);
+    --waiters;
+  }
+
+  template <typename Rep, typename Period, typename Ready>
+  static void waitFor(std::condition_variable& condition,
+                      std::size_t& waiters, std::unique_lock<std::mutex>& lock,
+                      const std::chrono::duration<Rep, Period>& timeout,
+                      Ready ready) {
+    if (ready()) {
+      return;
+    }
+
+    ++waiters;
+    condition.wait_for(lock, timeout, ready);
+    --waiters;
+  }
+
+  // Unlocks and wakes as many waiters as there are new values or free
+  // slots, if there are any waiters.
+  static void wake(std::condition_variable& condition, std::size_t waiters,
+                   std::unique_lock<std::mutex>& lock, std::size_t count) {
+    lock.unlock();
+    if (!waiters) {
+      return;
+    }
+
+    if (count > 1) {
+      condition.notify_all();
+    } else {
+      condition.notify_one();
+    }
+  }
+
+  bool take(T& value, std::unique_lock<std::mutex>& lock) {
+    if (!queue_.tryDequeue(value)) {
+      return false;
+    }
+
+    wake(not_full_, capacity_ ? waiting_producers_ : 0, lock, 1);
+    return true;
+  }
+
+  std::size_t takeBulk(T* values, std::size_t count,
+                       std::unique_lock<std::mutex>& lock) {
+    auto taken = queue_.dequeueBulk(values, count);
+    if (taken) {
+      wake(not_full_, capacity_ ? waiting_producers_ : 0, lock, taken);
+    }
+
+    return taken;
+  }
+
+ private:
+  Queue<T, NoStats, Allocator> queue_;
+  std::size_t capacity_;
+  bool closed_;
+  std::size_t waiting_consumers_;
+  std::size_t waiting_producers_;
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
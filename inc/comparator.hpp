@@ -21,53 +21,295 @@
 // SOFTWARE.
 
 #pragma once
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "batch_compare.hpp"
 
+// Default comparison policy. Resolved at compile time so that containers using
+// it get the comparison inlined instead of going through an indirect call.
 template <typename T>
-class Comparator {
+struct DefaultCompare {
+  int operator()(const T& a, const T& b) const {
+    if (a == b) return 0;
+
+    return a < b ? -1 : 1;
+  }
+};
+
+// Runtime comparison policy wrapping a user supplied compare function. Falls
+// back to DefaultCompare when no function is given.
+template <typename T>
+class FunctionCompare {
  public:
   using compare_func_t = std::function<int(const T& a, const T& b)>;
 
  public:
-  explicit Comparator(std::nullptr_t)
-      : is_default_(true), comparator_(defaultCompare) {}
+  FunctionCompare(std::nullptr_t = nullptr)  // NOLINT(runtime/explicit)
+      : is_default_(true), compare_(DefaultCompare<T>()) {}
+
+  template <typename F, typename = typename std::enable_if<
+                            std::is_constructible<compare_func_t, F>::value &&
+                            !std::is_same<typename std::decay<F>::type,
+                                          FunctionCompare>::value>::type>
+  FunctionCompare(F compare)  // NOLINT(runtime/explicit)
+      : is_default_(!compare_func_t(compare)),
+        compare_(is_default_ ? compare_func_t(DefaultCompare<T>())
+                             : compare_func_t(compare)) {}
+
+  int operator()(const T& a, const T& b) const { return compare_(a, b); }
+
+  void reverse() {
+    auto compareOriginal = compare_;
+    compare_ = [=](const T& a, const T& b) { return compareOriginal(b, a); };
+  }
+
+  explicit operator bool() const { return !is_default_; }
+
+ private:
+  bool is_default_;
+  compare_func_t compare_;
+};
+
+// Comparison policy ordering values by a key extracted with a projection,
+// such as a member or a normalized string. Containers aware of it (MinHeap and
+// BinarySearchTreeNode) extract the key once per element and keep it next to
+// the value, so comparisons only touch the cached keys.
+template <typename T, typename Projection,
+          typename Key = typename std::decay<decltype(std::declval<
+              const Projection&>()(std::declval<const T&>()))>::type,
+          typename KeyCompare = DefaultCompare<Key>>
+class ProjectionCompare {
+ public:
+  using key_type = Key;
+
+ public:
+  explicit ProjectionCompare(Projection projection = Projection(),
+                             KeyCompare compareKeys = KeyCompare())
+      : projection_(projection), key_compare_(compareKeys) {}
+
+  key_type project(const T& value) const { return projection_(value); }
+
+  int compareKeys(const key_type& a, const key_type& b) const {
+    return key_compare_(a, b);
+  }
+
+  // Projects both values on every call. Only containers that do not cache keys
+  // end up here.
+  int operator()(const T& a, const T& b) const {
+    return compareKeys(project(a), project(b));
+  }
+
+ private:
+  Projection projection_;
+  KeyCompare key_compare_;
+};
+
+// Lets the projection type be deduced, e.g. from a lambda.
+template <typename T, typename Projection>
+ProjectionCompare<T, Projection> makeProjectionCompare(Projection projection) {
+  return ProjectionCompare<T, Projection>(projection);
+}
+
+// Tells containers which key a policy compares. Plain policies compare the
+// values themselves, so there is nothing worth caching.
+template <typename T, typename Compare>
+struct KeyProjection {
+  using caching = std::false_type;
+  using key_type = T;
+  using key_result_type = const T&;
+
+  static const T& project(const Compare&, const T& value) { return value; }
+
+  static int compare(const Compare& compare, const T& a, const T& b) {
+    return compare(a, b);
+  }
+};
+
+template <typename T, typename Projection, typename Key, typename KeyCompare>
+struct KeyProjection<T, ProjectionCompare<T, Projection, Key, KeyCompare>> {
+  using compare_type = ProjectionCompare<T, Projection, Key, KeyCompare>;
+  using caching = std::true_type;
+  using key_type = Key;
+  using key_result_type = Key;
+
+  static Key project(const compare_type& compare, const T& value) {
+    return compare.project(value);
+  }
+
+  static int compare(const compare_type& compare, const Key& a, const Key& b) {
+    return compare.compareKeys(a, b);
+  }
+};
+
+template <typename T, typename Compare = DefaultCompare<T>>
+class Comparator {
+ public:
+  using compare_func_t = typename FunctionCompare<T>::compare_func_t;
+  using compare_type = Compare;
+  using key_projection_t = KeyProjection<T, Compare>;
+  using key_type = typename key_projection_t::key_type;
+
+ public:
+  explicit Comparator(Compare compare = Compare()) : compare_(compare) {}
 
-  explicit Comparator(compare_func_t compare = nullptr)
-      : is_default_(!compare),
-        comparator_(is_default_ ? defaultCompare : compare) {}
+  int compare(const T& a, const T& b) const { return compare_(a, b); }
 
-  bool equal(const T& a, const T& b) const { return comparator_(a, b) == 0; }
+  bool equal(const T& a, const T& b) const { return compare_(a, b) == 0; }
 
-  bool lessThan(const T& a, const T& b) const { return comparator_(a, b) < 0; }
+  bool lessThan(const T& a, const T& b) const { return compare_(a, b) < 0; }
 
   bool greaterThan(const T& a, const T& b) const {
-    return comparator_(a, b) > 0;
+    return compare_(a, b) > 0;
   }
 
   bool lessThanOrEqual(const T& a, const T& b) const {
-    return lessThan(a, b) || equal(a, b);
+    return compare_(a, b) <= 0;
   }
 
   bool greaterThanOrEqual(const T& a, const T& b) const {
-    return greaterThan(a, b) || equal(a, b);
+    return compare_(a, b) >= 0;
   }
 
-  void reverse() {
-    auto compareOriginal = comparator_;
-    comparator_ = [=](const T& a, const T& b) { return compareOriginal(b, a); };
+  // Compares each of count contiguous values with the key and stores
+  // compare(values[i], key) in results[i]. Vectorized for DefaultCompare over
+  // int, float and double.
+  void compareMany(const T& key, const T* values, std::size_t count,
+                   int* results) const {
+    BatchCompare<T, Compare>::compareMany(compare_, key, values, count,
+                                          results);
   }
 
+  // Index of the first smallest of count contiguous values, count must not be
+  // zero. Vectorized like compareMany.
+  std::size_t minIndex(const T* values, std::size_t count) const {
+    return BatchCompare<T, Compare>::minIndex(compare_, values, count);
+  }
+
+  // The key the policy compares the value by: the value itself, or its
+  // projection for ProjectionCompare.
+  typename key_projection_t::key_result_type key(const T& value) const {
+    return key_projection_t::project(compare_, value);
+  }
+
+  int compareKeys(const key_type& a, const key_type& b) const {
+    return key_projection_t::compare(compare_, a, b);
+  }
+
+  // Only available for policies that can be reversed at runtime, such as
+  // FunctionCompare.
+  void reverse() { compare_.reverse(); }
+
+  const Compare& policy() const { return compare_; }
+
  public:
-  explicit operator bool() const { return !is_default_; }
+  // Tells whether a custom compare function was supplied. Only available for
+  // runtime policies.
+  explicit operator bool() const { return static_cast<bool>(compare_); }
 
  private:
-  static int defaultCompare(const T& a, const T& b) {
-    if (a == b) return 0;
+  Compare compare_;
+};
 
-    return a < b ? -1 : 1;
+// The key of a single value, cached for policies with a projection. Empty for
+// the others, whose key is the value itself.
+template <typename T, typename Compare,
+          bool = KeyProjection<T, Compare>::caching::value>
+class CachedKey {
+ public:
+  using key_type = typename KeyProjection<T, Compare>::key_type;
+
+ public:
+  CachedKey() : key_() {}
+
+  CachedKey(const Compare& compare, const T& value)
+      : key_(KeyProjection<T, Compare>::project(compare, value)) {}
+
+  const key_type& cachedKey(const T&) const { return key_; }
+
+ private:
+  key_type key_;
+};
+
+template <typename T, typename Compare>
+class CachedKey<T, Compare, false> {
+ public:
+  CachedKey() {}
+
+  CachedKey(const Compare&, const T&) {}
+
+  const T& cachedKey(const T& value) const { return value; }
+};
+
+// The keys of a sequence of values, kept in a vector parallel to the values
+// for policies with a projection. Empty for the others.
+template <typename T, typename Compare, typename Allocator,
+          bool = KeyProjection<T, Compare>::caching::value>
+class CachedKeys {
+ public:
+  using key_type = typename KeyProjection<T, Compare>::key_type;
+  using key_allocator_t = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<key_type>;
+
+ public:
+  explicit CachedKeys(const Allocator& allocator) : keys_(allocator) {}
+
+  template <typename Values>
+  const key_type& at(const Values&, std::size_t index) const {
+    return keys_[index];
+  }
+
+  void pushBack(const Compare& compare, const T& value) {
+    keys_.push_back(KeyProjection<T, Compare>::project(compare, value));
+  }
+
+  void popBack() { keys_.pop_back(); }
+
+  // Moves the last key to index and drops the last slot.
+  void moveBack(std::size_t index) {
+    keys_[index] = std::move(keys_.back());
+    keys_.pop_back();
+  }
+
+  void swap(std::size_t indexOne, std::size_t indexTwo) {
+    using std::swap;
+    swap(keys_[indexOne], keys_[indexTwo]);
+  }
+
+  template <typename Values>
+  void rebuild(const Compare& compare, const Values& values) {
+    keys_.clear();
+    keys_.reserve(values.size());
+    for (auto& value : values) {
+      pushBack(compare, value);
+    }
   }
 
  private:
-  bool is_default_;
-  compare_func_t comparator_;
+  std::vector<key_type, key_allocator_t> keys_;
+};
+
+template <typename T, typename Compare, typename Allocator>
+class CachedKeys<T, Compare, Allocator, false> {
+ public:
+  explicit CachedKeys(const Allocator&) {}
+
+  template <typename Values>
+  const T& at(const Values& values, std::size_t index) const {
+    return values[index];
+  }
+
+  void pushBack(const Compare&, const T&) {}
+
+  void popBack() {}
+
+  void moveBack(std::size_t) {}
+
+  void swap(std::size_t, std::size_t) {}
+
+  template <typename Values>
+  void rebuild(const Compare&, const Values&) {}
 };
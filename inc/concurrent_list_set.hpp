@@ -0,0 +1,229 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "comparator.hpp"
+#include "epoch_reclaimer.hpp"
+
+// Node of ConcurrentListSet. The lowest bit of next_ marks the node as
+// removed, so that no node can be linked after it anymore.
+template <typename T>
+class ConcurrentListNode : public EpochReclaimer::Retired {
+ public:
+  template <typename... Args>
+  explicit ConcurrentListNode(Args&&... args)
+      : EpochReclaimer::Retired(&ConcurrentListNode::destroy),
+        value_(std::forward<Args>(args)...),
+        next_(0) {}
+
+  static void destroy(EpochReclaimer::Retired* node) {
+    delete static_cast<ConcurrentListNode*>(node);
+  }
+
+ public:
+  T value_;
+  std::atomic<std::uintptr_t> next_;
+};
+
+// Ordered set of unique values shared between threads, after the lock-free
+// list of Harris and Michael. insert() and remove() are lock-free, contains()
+// is wait-free. A removal first marks the node and then unlinks it, traversals
+// help to unlink marked nodes on the way. Unlinked nodes are reclaimed through
+// an EpochReclaimer, so readers never touch freed memory.
+template <typename T, typename Compare = DefaultCompare<T>>
+class ConcurrentListSet {
+ public:
+  using node_t = ConcurrentListNode<T>;
+
+ public:
+  explicit ConcurrentListSet(Compare compare = Compare())
+      : head_(0), comparator_(compare) {}
+
+  ConcurrentListSet(const ConcurrentListSet&) = delete;
+  ConcurrentListSet& operator=(const ConcurrentListSet&) = delete;
+
+  // No other thread may use the set anymore.
+  ~ConcurrentListSet() {
+    auto node = pointer(head_.load());
+    while (node) {
+      auto next = pointer(node->next_.load());
+      delete node;
+      node = next;
+    }
+  }
+
+  // Returns false if an equal value is in the set already.
+  template <typename... Args>
+  bool insert(Args&&... args) {
+    auto newNode = new node_t(std::forward<Args>(args)...);
+    EpochReclaimer::Guard guard(reclaimer_);
+
+    while (true) {
+      auto position = search(newNode->value_);
+      if (position.found_) {
+        delete newNode;
+        return false;
+      }
+
+      auto next = reinterpret_cast<std::uintptr_t>(position.current_);
+      newNode->next_.store(next, std::memory_order_relaxed);
+      if (position.link_->compare_exchange_strong(
+              next, reinterpret_cast<std::uintptr_t>(newNode),
+              std::memory_order_release, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  // Returns false if no equal value is in the set.
+  bool remove(const T& value) {
+    EpochReclaimer::Guard guard(reclaimer_);
+
+    while (true) {
+      auto position = search(value);
+      if (!position.found_) {
+        return false;
+      }
+
+      // Marking the node is the removal, unlinking it is only cleanup.
+      auto node = position.current_;
+      auto next = node->next_.load(std::memory_order_acquire);
+      if (marked(next) ||
+          !node->next_.compare_exchange_strong(next, next | MARK,
+                                               std::memory_order_acq_rel)) {
+        continue;
+      }
+
+      auto expected = reinterpret_cast<std::uintptr_t>(node);
+      if (position.link_->compare_exchange_strong(
+              expected, next, std::memory_order_acq_rel)) {
+        reclaimer_.retire(node);
+      } else {
+        search(value);
+      }
+
+      return true;
+    }
+  }
+
+  // Never helps unlinking, so it finishes in a bounded number of steps.
+  bool contains(const T& value) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+
+    auto node = pointer(head_.load(std::memory_order_acquire));
+    while (node && comparator_.lessThan(node->value_, value)) {
+      node = pointer(node->next_.load(std::memory_order_acquire));
+    }
+
+    return node && comparator_.equal(node->value_, value) &&
+           !marked(node->next_.load(std::memory_order_acquire));
+  }
+
+  // Values in order. Not a consistent snapshot while other threads write.
+  std::vector<T> toArray() const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    std::vector<T> values;
+
+    for (auto node = pointer(head_.load(std::memory_order_acquire)); node;) {
+      auto next = node->next_.load(std::memory_order_acquire);
+      if (!marked(next)) {
+        values.push_back(node->value_);
+      }
+      node = pointer(next);
+    }
+
+    return values;
+  }
+
+  bool isEmpty() const { return toArray().empty(); }
+
+  EpochReclaimer& reclaimer() const { return reclaimer_; }
+
+ private:
+  static const std::uintptr_t MARK = 1;
+
+  // Where a value belongs: current_ is the first node not less than it and
+  // link_ is the unmarked link pointing to current_.
+  struct Position {
+    std::atomic<std::uintptr_t>* link_;
+    node_t* current_;
+    bool found_;
+  };
+
+  static bool marked(std::uintptr_t link) { return link & MARK; }
+
+  static node_t* pointer(std::uintptr_t link) {
+    return reinterpret_cast<node_t*>(link & ~MARK);
+  }
+
+  // Unlinks the marked nodes it passes on the way.
+  Position search(const T& value) {
+    Position position;
+    while (!trySearch(value, position)) {
+    }
+
+    return position;
+  }
+
+  // Fails when a link changes under it, the search then starts over.
+  bool trySearch(const T& value, Position& position) {
+    auto link = &head_;
+    auto current = pointer(link->load(std::memory_order_acquire));
+
+    while (current) {
+      auto next = current->next_.load(std::memory_order_acquire);
+
+      if (marked(next)) {
+        auto expected = reinterpret_cast<std::uintptr_t>(current);
+        if (!link->compare_exchange_strong(expected, next & ~MARK,
+                                           std::memory_order_acq_rel)) {
+          return false;
+        }
+        reclaimer_.retire(current);
+        current = pointer(next);
+        continue;
+      }
+
+      auto result = comparator_.compare(current->value_, value);
+      if (result >= 0) {
+        position = Position{link, current, result == 0};
+        return true;
+      }
+
+      link = &current->next_;
+      current = pointer(next);
+    }
+
+    position = Position{link, nullptr, false};
+    return true;
+  }
+
+ private:
+  std::atomic<std::uintptr_t> head_;
+  Comparator<T, Compare> comparator_;
+  mutable EpochReclaimer reclaimer_;
+};
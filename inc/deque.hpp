@@ -0,0 +1,430 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
+
+// Double-ended queue stored as a map of chunks that hold K values each.
+// Pushing and popping at either end is O(1) and allocates only when a new
+// chunk is needed. Values never move once built, so pointers and references
+// to them stay valid until they are popped. Chunks emptied by pops are kept
+// and reused, so a deque that slides through its map, as a FIFO does, stops
+// allocating once it has reached its working set.
+template <typename T, std::size_t K = 64, typename Stats = NoStats,
+          typename Allocator = std::allocator<T>>
+class Deque {
+  static_assert(K > 0, "chunks must hold at least one value");
+
+ public:
+  // Number of chunk pointers in the first map.
+  static const std::size_t MIN_MAP_SIZE = 8;
+
+ public:
+  explicit Deque(const Allocator& allocator = Allocator())
+      : map_(nullptr),
+        map_size_(0),
+        start_(0),
+        size_(0),
+        allocator_(allocator) {}
+
+  Deque(const Deque& other)
+      : map_(nullptr),
+        map_size_(0),
+        start_(0),
+        size_(0),
+        allocator_(other.allocator_) {
+    try {
+      for (std::size_t i = 0; i < other.size_; ++i) {
+        emplaceBack(other[i]);
+      }
+    } catch (...) {
+      clear();
+      freeChunks();
+      throw;
+    }
+  }
+
+  Deque(Deque&& other)
+      : map_(other.map_),
+        map_size_(other.map_size_),
+        start_(other.start_),
+        size_(other.size_),
+        allocator_(other.allocator_) {
+    other.map_ = nullptr;
+    other.map_size_ = other.start_ = other.size_ = 0;
+  }
+
+  Deque& operator=(Deque other) {
+    swap(other);
+    return *this;
+  }
+
+  ~Deque() {
+    clear();
+    freeChunks();
+  }
+
+  void swap(Deque& other) {
+    using std::swap;
+    swap(map_, other.map_);
+    swap(map_size_, other.map_size_);
+    swap(start_, other.start_);
+    swap(size_, other.size_);
+    swap(stats_, other.stats_);
+    swap(allocator_, other.allocator_);
+  }
+
+  bool isEmpty() const { return !size_; }
+
+  std::size_t size() const { return size_; }
+
+  // The value index places behind the front. index must be below size().
+  T& operator[](std::size_t index) { return *slot(start_ + index); }
+
+  const T& operator[](std::size_t index) const {
+    return *slot(start_ + index);
+  }
+
+  T* front() { return size_ ? slot(start_) : nullptr; }
+
+  const T* front() const { return size_ ? slot(start_) : nullptr; }
+
+  T* back() { return size_ ? slot(start_ + size_ - 1) : nullptr; }
+
+  const T* back() const { return size_ ? slot(start_ + size_ - 1) : nullptr; }
+
+  void pushFront(const T& value) { emplaceFront(value); }
+
+  void pushFront(T&& value) { emplaceFront(std::move(value)); }
+
+  void pushBack(const T& value) { emplaceBack(value); }
+
+  void pushBack(T&& value) { emplaceBack(std::move(value)); }
+
+  template <typename... Args>
+  T& emplaceFront(Args&&... args) {
+    if (!start_) {
+      makeRoom();
+    }
+
+    // Nothing moves to make room, so args may refer to a value in the deque.
+    auto address = claim(start_ - 1);
+    construct(address, std::forward<Args>(args)...);
+    --start_;
+    ++size_;
+    return *address;
+  }
+
+  template <typename... Args>
+  T& emplaceBack(Args&&... args) {
+    if (start_ + size_ == map_size_ * K) {
+      makeRoom();
+    }
+
+    auto address = claim(start_ + size_);
+    construct(address, std::forward<Args>(args)...);
+    ++size_;
+    return *address;
+  }
+
+  // Returns T() if the deque is empty, use tryPopFront to tell it apart.
+  T popFront() {
+    if (!size_) {
+      return T();
+    }
+
+    auto address = slot(start_);
+    T value(std::move(*address));
+    dropFront(address);
+    return value;
+  }
+
+  // Returns T() if the deque is empty, use tryPopBack to tell it apart.
+  T popBack() {
+    if (!size_) {
+      return T();
+    }
+
+    auto address = slot(start_ + size_ - 1);
+    T value(std::move(*address));
+    dropBack(address);
+    return value;
+  }
+
+  // Moves the front into value. Returns false and leaves value alone if the
+  // deque is empty.
+  bool tryPopFront(T& value) {
+    if (!size_) {
+      return false;
+    }
+
+    auto address = slot(start_);
+    value = std::move(*address);
+    dropFront(address);
+    return true;
+  }
+
+  // Moves the back into value. Returns false and leaves value alone if the
+  // deque is empty.
+  bool tryPopBack(T& value) {
+    if (!size_) {
+      return false;
+    }
+
+    auto address = slot(start_ + size_ - 1);
+    value = std::move(*address);
+    dropBack(address);
+    return true;
+  }
+
+  // Keeps the chunks and gathers them in the middle of the map, so refilling
+  // the deque from either end reuses them before it allocates.
+  void clear() {
+    for (std::size_t i = 0; i < size_; ++i) {
+      slot(start_ + i)->~T();
+    }
+
+    size_ = 0;
+    auto chunks = std::partition(map_, map_ + map_size_, [](T* chunk) {
+                    return chunk != nullptr;
+                  }) - map_;
+    std::rotate(map_, map_ + (map_size_ + chunks) / 2, map_ + map_size_);
+    recenter();
+  }
+
+  // Frees the chunks that hold no values.
+  void shrinkToFit() {
+    auto first = start_ / K;
+    auto last = size_ ? (start_ + size_ - 1) / K + 1 : first;
+    for (std::size_t i = 0; i < map_size_; ++i) {
+      if (map_[i] && (i < first || i >= last)) {
+        deallocateChunk(map_[i]);
+        map_[i] = nullptr;
+      }
+    }
+  }
+
+  std::vector<T> toArray() const {
+    std::vector<T> values;
+    values.reserve(size_);
+    for (std::size_t i = 0; i < size_; ++i) {
+      values.push_back((*this)[i]);
+    }
+
+    return values;
+  }
+
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(size_));
+    for (std::size_t i = 0; i < size_; ++i) {
+      writer.write((*this)[i]);
+    }
+  }
+
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    clear();
+    for (std::uint64_t index = 0; index < count; ++index) {
+      emplaceBack(reader.read<T>());
+    }
+  }
+
+  // Writes the values from front to back separated by commas.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeValues(writer, [&](const T& value) { writer.write(value); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeValues(writer,
+                       [&](const T& value) { writer.write(callback(value)); });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  using traits_t = std::allocator_traits<Allocator>;
+  using map_allocator_t = typename traits_t::template rebind_alloc<T*>;
+  using map_traits_t = std::allocator_traits<map_allocator_t>;
+
+  // Positions count values from the start of the first chunk in the map.
+  T* slot(std::size_t position) const {
+    return map_[position / K] + position % K;
+  }
+
+  // Returns the slot at position, allocating its chunk if it has none.
+  T* claim(std::size_t position) {
+    auto& chunk = map_[position / K];
+    if (!chunk) {
+      stats_.countAllocation();
+      chunk = traits_t::allocate(allocator_, K);
+    }
+
+    return chunk + position % K;
+  }
+
+  template <typename... Args>
+  static void construct(T* address, Args&&... args) {
+    ::new (static_cast<void*>(address)) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys the front, which lives at address.
+  void dropFront(T* address) {
+    address->~T();
+    ++start_;
+    if (!--size_) {
+      recenter();
+    }
+  }
+
+  // Destroys the back, which lives at address.
+  void dropBack(T* address) {
+    address->~T();
+    if (!--size_) {
+      recenter();
+    }
+  }
+
+  // An empty deque restarts in the middle of its map, so it can grow either
+  // way before it has to make room.
+  void recenter() { start_ = map_size_ / 2 * K; }
+
+  // Gives the values a free chunk at both ends of the map. Only chunk
+  // pointers move, so the values stay where they are. The map doubles when
+  // the values fill more than half of it, otherwise the chunks are rotated
+  // to center the values. Spare chunks rotate along and are reused.
+  void makeRoom() {
+    auto first = start_ / K;
+    auto used = size_ ? (start_ + size_ - 1) / K + 1 - first : 0;
+
+    if (map_size_ >= 2 * (used + 1)) {
+      auto target = (map_size_ - used) / 2;
+      if (target < first) {
+        std::rotate(map_, map_ + (first - target), map_ + map_size_);
+      } else {
+        std::rotate(map_, map_ + map_size_ - (target - first),
+                    map_ + map_size_);
+      }
+      start_ = target * K + start_ % K;
+      return;
+    }
+
+    auto mapSize = map_size_ ? 2 * map_size_ : MIN_MAP_SIZE;
+    while (mapSize < 2 * (used + 1)) {
+      mapSize *= 2;
+    }
+
+    map_allocator_t mapAllocator(allocator_);
+    stats_.countAllocation();
+    auto map = map_traits_t::allocate(mapAllocator, mapSize);
+
+    // The used chunks go to the middle and the spare ones around them.
+    auto target = (mapSize - used) / 2;
+    std::fill(map, map + mapSize, nullptr);
+    for (std::size_t i = 0; i < map_size_; ++i) {
+      map[(target + mapSize + i - first) % mapSize] = map_[i];
+    }
+
+    if (map_) {
+      map_traits_t::deallocate(mapAllocator, map_, map_size_);
+    }
+    map_ = map;
+    map_size_ = mapSize;
+    start_ = target * K + start_ % K;
+  }
+
+  void deallocateChunk(T* chunk) { traits_t::deallocate(allocator_, chunk, K); }
+
+  void freeChunks() {
+    if (!map_) {
+      return;
+    }
+
+    for (std::size_t i = 0; i < map_size_; ++i) {
+      if (map_[i]) {
+        deallocateChunk(map_[i]);
+      }
+    }
+
+    map_allocator_t mapAllocator(allocator_);
+    map_traits_t::deallocate(mapAllocator, map_, map_size_);
+    map_ = nullptr;
+    map_size_ = start_ = 0;
+  }
+
+  template <typename Writer, typename WriteValue>
+  Writer& writeValues(Writer& writer, WriteValue writeValue) const {
+    for (std::size_t i = 0; i < size_; ++i) {
+      if (i) {
+        writer.write(',');
+      }
+
+      writeValue((*this)[i]);
+    }
+
+    return writer;
+  }
+
+ private:
+  T** map_;
+  std::size_t map_size_;
+  std::size_t start_;
+  std::size_t size_;
+  Stats stats_;
+  Allocator allocator_;
+};
+
+template <typename T, std::size_t K, typename Stats, typename Allocator>
+const std::size_t Deque<T, K, Stats, Allocator>::MIN_MAP_SIZE;
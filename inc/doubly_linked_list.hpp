@@ -0,0 +1,395 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "comparator.hpp"
+#include "doubly_linked_list_node.hpp"
+#include "list_iterator.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
+
+// Linked list whose nodes also point back to their predecessor, so that both
+// ends can be removed and any node can be unlinked or moved given its handle
+// in constant time. Meant as a building block for structures such as LRU
+// caches that keep handles to their nodes.
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class DoublyLinkedList {
+ public:
+  using node_t = DoublyLinkedListNode<T>;
+  using iterator = ListIterator<node_t, T>;
+  using const_iterator = ListIterator<const node_t, const T>;
+
+ public:
+  explicit DoublyLinkedList(Compare compare = Compare(),
+                            const Allocator& allocator = Allocator())
+      : head_(nullptr),
+        tail_(nullptr),
+        comparator_(compare),
+        allocator_(allocator) {}
+
+  // Copies the values into nodes of its own. Sharing the nodes would let
+  // either list rewire the other one.
+  DoublyLinkedList(const DoublyLinkedList& other)
+      : head_(nullptr),
+        tail_(nullptr),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    try {
+      for (auto& value : other) {
+        emplaceAppend(value);
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  DoublyLinkedList(DoublyLinkedList&& other) = default;
+
+  DoublyLinkedList& operator=(DoublyLinkedList other) {
+    swap(other);
+    return *this;
+  }
+
+  ~DoublyLinkedList() { clear(); }
+
+  void swap(DoublyLinkedList& other) {
+    using std::swap;
+    swap(head_, other.head_);
+    swap(tail_, other.tail_);
+    swap(comparator_, other.comparator_);
+    swap(stats_, other.stats_);
+    swap(allocator_, other.allocator_);
+  }
+
+  DoublyLinkedList& prepend(const T& value) { return emplacePrepend(value); }
+
+  DoublyLinkedList& prepend(T&& value) {
+    return emplacePrepend(std::move(value));
+  }
+
+  DoublyLinkedList& append(const T& value) { return emplaceAppend(value); }
+
+  DoublyLinkedList& append(T&& value) {
+    return emplaceAppend(std::move(value));
+  }
+
+  template <typename... Args>
+  DoublyLinkedList& emplacePrepend(Args&&... args) {
+    linkFront(makeNode(std::forward<Args>(args)...));
+    return *this;
+  }
+
+  template <typename... Args>
+  DoublyLinkedList& emplaceAppend(Args&&... args) {
+    linkBack(makeNode(std::forward<Args>(args)...));
+    return *this;
+  }
+
+  // Removes every node holding value and returns the last one removed.
+  std::shared_ptr<node_t> remove(const T& value) {
+    std::shared_ptr<node_t> deletedNode = nullptr;
+
+    auto currentNode = head_;
+    while (currentNode) {
+      auto nextNode = currentNode->next_;
+      if (equal(currentNode->value_, value)) {
+        deletedNode = unlink(std::move(currentNode));
+      }
+
+      currentNode = std::move(nextNode);
+    }
+
+    return deletedNode;
+  }
+
+  std::shared_ptr<node_t> find(const T& value) const {
+    return find([&](const T& test) { return equal(test, value); });
+  }
+
+  std::shared_ptr<node_t> find(std::function<bool(const T&)> callback) const {
+    if (!callback) {
+      return nullptr;
+    }
+
+    return findNode(callback);
+  }
+
+  // Same as above but keeps the type of the callback so that it can be
+  // inlined instead of being called through std::function.
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::shared_ptr<node_t> find(Callback&& callback) const {
+    return findNode(callback);
+  }
+
+  std::shared_ptr<node_t> deleteHead() {
+    if (!head_) {
+      return nullptr;
+    }
+
+    return unlink(head_);
+  }
+
+  std::shared_ptr<node_t> deleteTail() {
+    if (!tail_) {
+      return nullptr;
+    }
+
+    return unlink(tail_);
+  }
+
+  // Detaches a node of this list and returns it. The node is taken by value
+  // so that it stays alive while the links pointing to it are rewired.
+  // Returns nullptr and leaves the list unchanged for a detached node or an
+  // end node of another list. An inner node of another list is detached
+  // from that list, since its neighbours are all there is to check.
+  std::shared_ptr<node_t> unlink(std::shared_ptr<node_t> node) {
+    if (!node || !isLinked(*node)) {
+      return nullptr;
+    }
+
+    auto previousNode = node->previous_.lock();
+
+    if (previousNode) {
+      previousNode->next_ = node->next_;
+    } else {
+      head_ = node->next_;
+    }
+
+    if (node->next_) {
+      node->next_->previous_ = previousNode;
+    } else {
+      tail_ = previousNode;
+    }
+
+    node->next_ = nullptr;
+    node->previous_.reset();
+
+    return node;
+  }
+
+  // Moves a node of this list to the head. Nodes that unlink rejects are
+  // left alone.
+  DoublyLinkedList& moveToFront(std::shared_ptr<node_t> node) {
+    if (node != head_) {
+      node = unlink(std::move(node));
+      if (node) {
+        linkFront(std::move(node));
+      }
+    }
+
+    return *this;
+  }
+
+  // Releases the nodes one by one. Letting the chain of shared_ptr links go
+  // at once would destroy it recursively, one stack frame per node. Nodes
+  // still referenced from outside the list keep the rest of their chain.
+  void clear() {
+    tail_.reset();
+    while (head_ && head_.use_count() == 1) {
+      head_ = std::move(head_->next_);
+    }
+    head_.reset();
+  }
+
+  iterator begin() { return iterator(head_.get()); }
+
+  iterator end() { return iterator(); }
+
+  const_iterator begin() const { return const_iterator(head_.get()); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  // Copies the values from head to tail.
+  std::vector<T> values() const { return std::vector<T>(begin(), end()); }
+
+  // Copies whole nodes, so every copied link touches a reference count.
+  LIST_DEPRECATED("copies the node links, use values() or the iterators")
+  std::vector<node_t> toArray() const {
+    std::vector<node_t> nodes;
+
+    for (auto it = begin(); it != end(); ++it) {
+      nodes.push_back(*it.node());
+    }
+
+    return nodes;
+  }
+
+  // Writes the values separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeNodes(writer,
+                      [&](const node_t& node) { writer.write(node.value_); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeNodes(writer, [&](const node_t& node) {
+      writer.write(node.toString(callback));
+    });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  // Writes the values from head to tail as a SEQUENCE snapshot, the same
+  // format as LinkedList.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(std::distance(begin(), end())));
+    for (auto& value : *this) {
+      writer.write(value);
+    }
+  }
+
+  // Replaces the content of the list with the values of a SEQUENCE snapshot.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    clear();
+    for (std::uint64_t index = 0; index < count; ++index) {
+      emplaceAppend(reader.read<T>());
+    }
+  }
+
+ public:
+  const Stats& stats() const { return stats_; }
+
+  Allocator getAllocator() const { return allocator_; }
+
+ private:
+  template <typename Writer, typename WriteNode>
+  Writer& writeNodes(Writer& writer, WriteNode writeNode) const {
+    for (auto it = begin(); it != end(); ++it) {
+      if (it != begin()) {
+        writer.write(',');
+      }
+
+      writeNode(*it.node());
+    }
+
+    return writer;
+  }
+
+  template <typename... Args>
+  std::shared_ptr<node_t> makeNode(Args&&... args) {
+    stats_.countAllocation();
+    return std::allocate_shared<node_t>(allocator_,
+                                        typename node_t::emplace_t(),
+                                        std::forward<Args>(args)...);
+  }
+
+  // Tells whether the neighbours of a node, or the ends of the list where it
+  // has none, point back at it.
+  bool isLinked(const node_t& node) const {
+    auto previousNode = node.previous_.lock();
+    if (previousNode ? previousNode->next_.get() != &node
+                     : head_.get() != &node) {
+      return false;
+    }
+
+    return node.next_ ? node.next_->previous_.lock().get() == &node
+                      : tail_.get() == &node;
+  }
+
+  void linkFront(std::shared_ptr<node_t> node) {
+    if (head_) {
+      head_->previous_ = node;
+    } else {
+      tail_ = node;
+    }
+
+    node->next_ = std::move(head_);
+    head_ = std::move(node);
+  }
+
+  void linkBack(std::shared_ptr<node_t> node) {
+    node->previous_ = tail_;
+
+    if (tail_) {
+      tail_->next_ = node;
+    } else {
+      head_ = node;
+    }
+
+    tail_ = std::move(node);
+  }
+
+  template <typename Callback>
+  std::shared_ptr<node_t> findNode(Callback& callback) const {
+    // Walks the links themselves so that only the found node is copied.
+    for (auto link = &head_; *link; link = &(*link)->next_) {
+      stats_.countNodeVisit();
+
+      if (callback((*link)->value_)) {
+        return *link;
+      }
+    }
+
+    return nullptr;
+  }
+
+  bool equal(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.equal(a, b);
+  }
+
+ public:
+  std::shared_ptr<node_t> head_;
+  std::shared_ptr<node_t> tail_;
+
+ private:
+  Comparator<T, Compare> comparator_;
+  mutable Stats stats_;
+  Allocator allocator_;
+};
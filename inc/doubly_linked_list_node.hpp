@@ -0,0 +1,80 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+template <typename T>
+class DoublyLinkedListNode {
+ public:
+  // Selects the constructor that builds the value in place.
+  struct emplace_t {};
+
+ public:
+  explicit DoublyLinkedListNode(
+      const T& value, std::shared_ptr<DoublyLinkedListNode> next = nullptr,
+      std::weak_ptr<DoublyLinkedListNode> previous =
+          std::weak_ptr<DoublyLinkedListNode>())
+      : value_(value), next_(std::move(next)), previous_(std::move(previous)) {}
+
+  explicit DoublyLinkedListNode(
+      T&& value, std::shared_ptr<DoublyLinkedListNode> next = nullptr,
+      std::weak_ptr<DoublyLinkedListNode> previous =
+          std::weak_ptr<DoublyLinkedListNode>())
+      : value_(std::move(value)),
+        next_(std::move(next)),
+        previous_(std::move(previous)) {}
+
+  template <typename... Args>
+  explicit DoublyLinkedListNode(emplace_t, Args&&... args)
+      : value_(std::forward<Args>(args)...), next_(nullptr), previous_() {}
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    if (callback)
+      return callback(value_);
+    else
+      return "DoublyLinkedListNode";
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    return callback(value_);
+  }
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << value_;
+    return ss.str();
+  }
+
+ public:
+  T value_;
+  std::shared_ptr<DoublyLinkedListNode> next_;
+  // Weak so that neighbours do not own each other.
+  std::weak_ptr<DoublyLinkedListNode> previous_;
+};
@@ -0,0 +1,194 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Epoch based memory reclamation for lock-free structures. Threads pin the
+// current epoch with a Guard while they may hold pointers into the
+// structure, and objects unlinked from it are retired instead of deleted. A
+// retired object is destroyed once the global epoch has moved on twice, by
+// then no guard that could have seen it is left.
+//
+// Guards are announced in per thread slots, so readers on different cores do
+// not write to shared cache lines. Threads beyond SLOT_COUNT share slots,
+// which is still correct but may hold back reclamation.
+class EpochReclaimer {
+ public:
+  static const std::size_t SLOT_COUNT = 64;
+  // Retirements between two attempts to reclaim.
+  static const std::size_t COLLECT_INTERVAL = 64;
+
+  // Base of the objects that can be retired.
+  struct Retired {
+    explicit Retired(void (*destroy)(Retired*))
+        : destroy_(destroy), next_(nullptr), epoch_(0) {}
+
+    void (*destroy_)(Retired*);
+    Retired* next_;
+    std::uint64_t epoch_;
+  };
+
+ private:
+  struct Slot;
+
+ public:
+  // Pins the current epoch for the calling thread while it is alive. Guards
+  // may be nested.
+  class Guard {
+   public:
+    explicit Guard(EpochReclaimer& reclaimer)
+        : slot_(reclaimer.slotOfThread()) {
+      reclaimer.pin(*slot_);
+    }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    ~Guard() { slot_->state_.fetch_sub(1); }
+
+   private:
+    Slot* slot_;
+  };
+
+ public:
+  EpochReclaimer()
+      : epoch_(1), slots_(new Slot[SLOT_COUNT]), retired_(nullptr),
+        retire_count_(0) {}
+
+  EpochReclaimer(const EpochReclaimer&) = delete;
+  EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+  // No guard may be alive anymore.
+  ~EpochReclaimer() {
+    auto retired = retired_.exchange(nullptr);
+    while (retired) {
+      auto next = retired->next_;
+      retired->destroy_(retired);
+      retired = next;
+    }
+  }
+
+  // Hands over an object that has been unlinked, so that no new guard can
+  // reach it. It is destroyed by a later collect().
+  void retire(Retired* retired) {
+    retired->epoch_ = epoch_.load();
+    push(retired, retired);
+
+    if (retire_count_.fetch_add(1) % COLLECT_INTERVAL == COLLECT_INTERVAL - 1) {
+      collect();
+    }
+  }
+
+  // Advances the epoch if every guard has seen the current one and destroys
+  // the retired objects no guard can reach anymore.
+  void collect() {
+    tryAdvance();
+
+    auto retired = retired_.exchange(nullptr);
+    auto epoch = epoch_.load();
+    Retired* keep = nullptr;
+    Retired* keepTail = nullptr;
+
+    while (retired) {
+      auto next = retired->next_;
+      if (retired->epoch_ + 2 <= epoch) {
+        retired->destroy_(retired);
+      } else {
+        retired->next_ = keep;
+        keepTail = keep ? keepTail : retired;
+        keep = retired;
+      }
+      retired = next;
+    }
+
+    if (keep) {
+      push(keep, keepTail);
+    }
+  }
+
+  std::uint64_t epoch() const { return epoch_.load(); }
+
+ private:
+  // Packs the epoch a slot has pinned with the number of guards holding it.
+  static const unsigned COUNT_BITS = 16;
+  static const std::uint64_t COUNT_MASK = (1u << COUNT_BITS) - 1;
+
+  // Padded to a cache line so that threads pinning do not share lines.
+  struct Slot {
+    Slot() : state_(0) {}
+
+    std::atomic<std::uint64_t> state_;
+    char padding_[64 - sizeof(std::atomic<std::uint64_t>)];
+  };
+
+  Slot* slotOfThread() {
+    static std::atomic<std::size_t> threadCount(0);
+    static thread_local std::size_t index = threadCount.fetch_add(1);
+
+    return &slots_[index % SLOT_COUNT];
+  }
+
+  // A slot shared with a guard of another thread keeps the older epoch,
+  // which only delays reclamation.
+  void pin(Slot& slot) {
+    auto state = slot.state_.load();
+    std::uint64_t pinned;
+    do {
+      pinned = state & COUNT_MASK ? state + 1
+                                  : (epoch_.load() << COUNT_BITS) | 1;
+    } while (!slot.state_.compare_exchange_weak(state, pinned));
+
+    // Loads from the structure must not move before the announcement.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  bool tryAdvance() {
+    auto epoch = epoch_.load();
+
+    for (std::size_t i = 0; i < SLOT_COUNT; ++i) {
+      auto state = slots_[i].state_.load();
+      if (state & COUNT_MASK && state >> COUNT_BITS != epoch) {
+        return false;
+      }
+    }
+
+    return epoch_.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  void push(Retired* first, Retired* last) {
+    auto head = retired_.load();
+    do {
+      last->next_ = head;
+    } while (!retired_.compare_exchange_weak(head, first));
+  }
+
+ private:
+  std::atomic<std::uint64_t> epoch_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<Retired*> retired_;
+  std::atomic<std::size_t> retire_count_;
+};
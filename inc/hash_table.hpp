@@ -22,78 +22,186 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <unordered_set>
 #include <utility>
 #include "linked_list.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
 
-template <typename T, std::size_t N = 32>
-class HashTable {
+template <typename T, std::size_t N = 32, typename Stats = NoStats,
+          typename Allocator = std::allocator<T>>
+class HashTable : private MutableStats<Stats> {
  public:
-  int hash(std::string key) const {
-    auto hash = std::accumulate(key.begin(), key.end(), 0);
+  using entry_t = std::pair<std::string, T>;
+  using entry_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<entry_t>;
+  using bucket_t =
+      LinkedList<entry_t, DefaultCompare<entry_t>, NoStats, entry_allocator_t>;
+
+ public:
+  HashTable() {}
+
+  explicit HashTable(const Allocator& allocator) {
+    for (auto& bucket : buckets_) {
+      bucket = bucket_t(DefaultCompare<entry_t>(), allocator);
+    }
+  }
+
+  static int hash(const std::string& key) {
+    return hash(key.data(), key.size());
+  }
+
+  static int hash(const char* key, std::size_t length) {
+    auto hash = std::accumulate(key, key + length, 0);
 
     // Reduce hash number so it would fit hash table size.
-    return hash % buckets_.size();
+    return hash % N;
   }
 
-  void set(std::string key, const T& value) {
-    auto& bucketLinkedList = buckets_[hash(key)];
-    auto node =
-        bucketLinkedList.find([&](const std::pair<std::string, T>& elem) {
-          return elem.first == key;
-        });
+  void set(std::string key, const T& value) { assign(std::move(key), value); }
 
-    if (!node) {
-      // Insert new node.
-      bucketLinkedList.append(std::make_pair(key, value));
-    } else {
-      // Update value of existing node.
-      node->value_.second = value;
-    }
+  void set(std::string key, T&& value) {
+    assign(std::move(key), std::move(value));
   }
 
   std::shared_ptr<LinkedListNode<std::pair<std::string, T>>> remove(
-      std::string key) {
+      const std::string& key) {
     auto& bucketLinkedList = buckets_[hash(key)];
-    auto node =
-        bucketLinkedList.find([&](const std::pair<std::string, T>& elem) {
-          return elem.first == key;
-        });
+    auto entry = findEntry(key.data(), key.size());
 
-    if (node) {
-      return bucketLinkedList.remove(node->value_);
+    if (entry) {
+      return bucketLinkedList.remove(*entry);
     }
 
     return nullptr;
   }
 
-  T* get(std::string key) const {
-    auto& bucketLinkedList = buckets_[hash(key)];
-    auto node =
-        bucketLinkedList.find([&](const std::pair<std::string, T>& elem) {
-          return elem.first == key;
-        });
+  T* get(const std::string& key) const { return get(key.data(), key.size()); }
+
+  // Looks up a key given as characters, so that callers holding something
+  // other than a std::string do not have to build one.
+  T* get(const char* key, std::size_t length) const {
+    auto entry = findEntry(key, length);
+    return entry ? &entry->second : nullptr;
+  }
 
-    return node ? &node->value_.second : nullptr;
+  bool has(const std::string& key) const { return get(key) != nullptr; }
+
+  bool has(const char* key, std::size_t length) const {
+    return get(key, length) != nullptr;
   }
 
-  bool has(std::string key) const { return get(key) != nullptr; }
+  void clear() {
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
+  }
 
   std::unordered_set<std::string> getKeys() const {
     std::unordered_set<std::string> keys;
 
-    for (auto bucket : buckets_) {
-      for (auto node = bucket.head_; node; node = node->next_) {
-        keys.insert(node->value_.first);
+    for (auto& bucket : buckets_) {
+      for (auto& entry : bucket) {
+        keys.insert(entry.first);
       }
     }
 
     return keys;
   }
 
+  // Writes a HASH_TABLE snapshot: the bucket count, the offset of every
+  // bucket relative to the first entry and then the entries bucket by bucket.
+  // The offsets let HashTableSnapshotView look keys up without a rebuild.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::HASH_TABLE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(N));
+
+    std::uint64_t offset = 0;
+    writer.write(offset);
+    for (auto& bucket : buckets_) {
+      for (auto& entry : bucket) {
+        offset += SnapshotCodec<entry_t>::size(entry);
+      }
+      writer.write(offset);
+    }
+
+    for (auto& bucket : buckets_) {
+      for (auto& entry : bucket) {
+        writer.write(entry);
+      }
+    }
+  }
+
+  // Replaces the content of the table with the entries of a HASH_TABLE
+  // snapshot. Snapshots taken with another bucket count are rehashed.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::HASH_TABLE, SnapshotCodec<T>::fixed_size);
+    auto bucketCount = reader.readCount(sizeof(std::uint64_t));
+    auto offsets = reader.take((bucketCount + 1) * sizeof(std::uint64_t));
+
+    std::uint64_t size;
+    std::memcpy(&size, offsets + bucketCount * sizeof(std::uint64_t),
+                sizeof(size));
+    if (size > reader.remaining()) {
+      throw SnapshotError("snapshot is truncated");
+    }
+
+    clear();
+
+    // Keys are unique in a snapshot, so entries are appended without the
+    // lookup set() does.
+    auto end = reader.position() + size;
+    while (reader.position() < end) {
+      auto key = reader.read<std::string>();
+      auto& bucketLinkedList = buckets_[hash(key)];
+      this->mutableStats().countAllocation();
+      bucketLinkedList.emplaceAppend(std::move(key), reader.read<T>());
+    }
+  }
+
+  const Stats& stats() const { return this->mutableStats(); }
+
  public:
-  std::array<LinkedList<std::pair<std::string, T>>, N> buckets_;
+  std::array<bucket_t, N> buckets_;
+
+ private:
+  // Walks the bucket of the key with iterators, which unlike
+  // LinkedList::find do not copy the shared_ptr links.
+  entry_t* findEntry(const char* key, std::size_t length) const {
+    auto& bucketLinkedList = buckets_[hash(key, length)];
+    auto it = std::find_if(bucketLinkedList.begin(), bucketLinkedList.end(),
+                           [&](const entry_t& elem) {
+                             this->mutableStats().countNodeVisit();
+                             return elem.first.size() == length &&
+                                    elem.first.compare(0, length, key,
+                                                       length) == 0;
+                           });
+
+    // Entries are handed out mutable, as get() always did from a const table.
+    return it != bucketLinkedList.end() ? const_cast<entry_t*>(&*it)
+                                        : nullptr;
+  }
+
+  template <typename Value>
+  void assign(std::string key, Value&& value) {
+    auto entry = findEntry(key.data(), key.size());
+
+    if (!entry) {
+      // Insert new node.
+      this->mutableStats().countAllocation();
+      buckets_[hash(key)].emplaceAppend(std::move(key),
+                                        std::forward<Value>(value));
+    } else {
+      // Update value of existing node.
+      entry->second = std::forward<Value>(value);
+    }
+  }
 };
@@ -23,46 +23,197 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <iterator>
 #include <memory>
-#include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 #include "comparator.hpp"
 #include "linked_list_node.hpp"
+#include "list_iterator.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
 
-template <typename T>
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
 class LinkedList {
  public:
-  explicit LinkedList(typename Comparator<T>::compare_func_t compare = nullptr)
-      : head_(nullptr), tail_(nullptr), comparator_(compare) {}
+  using iterator = ListIterator<LinkedListNode<T>, T>;
+  using const_iterator = ListIterator<const LinkedListNode<T>, const T>;
+
+ public:
+  explicit LinkedList(Compare compare = Compare(),
+                      const Allocator& allocator = Allocator())
+      : head_(nullptr),
+        tail_(nullptr),
+        comparator_(compare),
+        allocator_(allocator) {}
+
+  LinkedList(const LinkedList&) = default;
+
+  LinkedList(LinkedList&& other) = default;
+
+  LinkedList& operator=(const LinkedList& other) {
+    if (this != &other) {
+      clear();
+      head_ = other.head_;
+      tail_ = other.tail_;
+      comparator_ = other.comparator_;
+      stats_ = other.stats_;
+      allocator_ = other.allocator_;
+    }
+
+    return *this;
+  }
+
+  LinkedList& operator=(LinkedList&& other) {
+    if (this != &other) {
+      clear();
+      head_ = std::move(other.head_);
+      tail_ = std::move(other.tail_);
+      comparator_ = std::move(other.comparator_);
+      stats_ = std::move(other.stats_);
+      allocator_ = std::move(other.allocator_);
+    }
+
+    return *this;
+  }
+
+  ~LinkedList() { clear(); }
+
+  LinkedList& prepend(const T& value) { return emplacePrepend(value); }
+
+  LinkedList& prepend(T&& value) { return emplacePrepend(std::move(value)); }
+
+  LinkedList& append(const T& value) { return emplaceAppend(value); }
+
+  LinkedList& append(T&& value) { return emplaceAppend(std::move(value)); }
+
+  template <typename... Args>
+  LinkedList& emplacePrepend(Args&&... args) {
+    stats_.countAllocation();
 
-  LinkedList& prepend(const T& value) {
     // Make new node to be a head.
-    auto newNode = std::make_shared<LinkedListNode<T>>(value, head_);
+    auto newNode = std::allocate_shared<LinkedListNode<T>>(
+        allocator_, typename LinkedListNode<T>::emplace_t(), head_,
+        std::forward<Args>(args)...);
     head_ = newNode;
 
     // If there is no tail yet let's make new node a tail.
     if (!tail_) {
-      tail_ = newNode;
+      tail_ = std::move(newNode);
     }
 
     return *this;
   }
 
-  LinkedList& append(const T& value) {
-    auto newNode = std::make_shared<LinkedListNode<T>>(value);
+  template <typename... Args>
+  LinkedList& emplaceAppend(Args&&... args) {
+    stats_.countAllocation();
+    auto newNode = std::allocate_shared<LinkedListNode<T>>(
+        allocator_, typename LinkedListNode<T>::emplace_t(), nullptr,
+        std::forward<Args>(args)...);
 
     // If there is no head yet let's make new node a head.
     if (!head_) {
       head_ = newNode;
-      tail_ = newNode;
+      tail_ = std::move(newNode);
 
       return *this;
     }
 
     // Attach new node to the end of linked list.
     tail_->next_ = newNode;
-    tail_ = newNode;
+    tail_ = std::move(newNode);
+
+    return *this;
+  }
+
+  // Appends the values of [first, last). The nodes are linked to each other
+  // first and attached to the list in one step, so the list is left
+  // unchanged if building a value throws.
+  template <typename InputIterator>
+  LinkedList& appendRange(InputIterator first, InputIterator last) {
+    std::shared_ptr<LinkedListNode<T>> rangeHead;
+    std::shared_ptr<LinkedListNode<T>> rangeTail;
+    auto link = &rangeHead;
+
+    try {
+      for (; first != last; ++first) {
+        stats_.countAllocation();
+        auto newNode = std::allocate_shared<LinkedListNode<T>>(
+            allocator_, typename LinkedListNode<T>::emplace_t(), nullptr,
+            *first);
+        *link = newNode;
+        link = &newNode->next_;
+        rangeTail = std::move(newNode);
+      }
+    } catch (...) {
+      rangeTail.reset();
+      releaseChain(std::move(rangeHead));
+      throw;
+    }
+
+    if (rangeHead) {
+      attach(std::move(rangeHead), std::move(rangeTail));
+    }
+
+    return *this;
+  }
+
+  // Moves the nodes of other to the end of this list in constant time,
+  // leaving other empty.
+  LinkedList& splice(LinkedList& other) {
+    if (&other != this && other.head_) {
+      attach(std::move(other.head_), std::move(other.tail_));
+    }
+
+    return *this;
+  }
+
+  LinkedList& concat(LinkedList&& other) { return splice(other); }
+
+  // Sorts the list in place with a stable bottom-up merge sort. Nodes are
+  // relinked, values are neither copied nor moved.
+  LinkedList& sort() { return sort(comparator_); }
+
+  template <typename CustomCompare>
+  LinkedList& sort(const Comparator<T, CustomCompare>& comparator) {
+    // runs[i] is empty or holds a sorted run of 2^i nodes, all of them
+    // taken from the list before the nodes of runs[i - 1].
+    std::shared_ptr<LinkedListNode<T>> runs[sizeof(std::size_t) * 8];
+    std::size_t runCount = 0;
+
+    tail_.reset();
+    while (head_) {
+      auto carry = std::move(head_);
+      head_ = std::move(carry->next_);
+
+      std::size_t index = 0;
+      for (; index < runCount && runs[index]; ++index) {
+        carry = merge(std::move(runs[index]), std::move(carry), comparator);
+      }
+
+      runs[index] = std::move(carry);
+      if (index == runCount) {
+        ++runCount;
+      }
+    }
+
+    for (std::size_t index = 0; index < runCount; ++index) {
+      head_ = merge(std::move(runs[index]), std::move(head_), comparator);
+    }
+
+    // Find the new tail through the link that owns it.
+    if (head_) {
+      auto link = &head_;
+      while ((*link)->next_) {
+        link = &(*link)->next_;
+      }
+      tail_ = *link;
+    }
 
     return *this;
   }
@@ -75,9 +226,9 @@ class LinkedList {
     std::shared_ptr<LinkedListNode<T>> deletedNode = nullptr;
 
     // If the head must be deleted then make 2nd node to be a head.
-    while (head_ && comparator_.equal(head_->value_, value)) {
+    while (head_ && equal(head_->value_, value)) {
       deletedNode = head_;
-      head_ = head_->next_;
+      head_ = std::move(deletedNode->next_);
     }
 
     auto currentNode = head_;
@@ -85,9 +236,9 @@ class LinkedList {
     if (currentNode) {
       // If next node must be deleted then make next node to be a next next one.
       while (currentNode->next_) {
-        if (comparator_.equal(currentNode->next_->value_, value)) {
+        if (equal(currentNode->next_->value_, value)) {
           deletedNode = currentNode->next_;
-          currentNode->next_ = currentNode->next_->next_;
+          currentNode->next_ = std::move(deletedNode->next_);
         } else {
           currentNode = currentNode->next_;
         }
@@ -95,7 +246,7 @@ class LinkedList {
     }
 
     // Check if tail must be deleted.
-    if (comparator_.equal(tail_->value_, value)) {
+    if (equal(tail_->value_, value)) {
       tail_ = currentNode;
     }
 
@@ -103,27 +254,24 @@ class LinkedList {
   }
 
   std::shared_ptr<LinkedListNode<T>> find(const T& value) const {
-    return find([&](const T& test) { return comparator_.equal(test, value); });
+    return find([&](const T& test) { return equal(test, value); });
   }
 
   std::shared_ptr<LinkedListNode<T>> find(
       std::function<bool(const T&)> callback) const {
-    if (!head_ || !callback) {
+    if (!callback) {
       return nullptr;
     }
 
-    auto currentNode = head_;
-
-    while (currentNode) {
-      // If callback is specified then try to find node by callback.
-      if (callback(currentNode->value_)) {
-        return currentNode;
-      }
-
-      currentNode = currentNode->next_;
-    }
+    return findNode(callback);
+  }
 
-    return nullptr;
+  // Same as above but keeps the type of the callback so that it can be
+  // inlined instead of being called through std::function.
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::shared_ptr<LinkedListNode<T>> find(Callback&& callback) const {
+    return findNode(callback);
   }
 
   std::shared_ptr<LinkedListNode<T>> deleteTail() {
@@ -160,52 +308,184 @@ class LinkedList {
       return nullptr;
     }
 
+    // The removed node is detached so that it does not keep the rest of the
+    // list alive.
     auto deletedHead = head_;
+    head_ = std::move(deletedHead->next_);
 
-    if (head_->next_) {
-      head_ = head_->next_;
-    } else {
-      head_ = nullptr;
+    if (!head_) {
       tail_.reset();
     }
 
     return deletedHead;
   }
 
+  // Releases the nodes one by one. Letting the chain of shared_ptr links go
+  // at once would destroy it recursively, one stack frame per node. Nodes
+  // still referenced from outside the list keep the rest of their chain.
+  void clear() {
+    tail_.reset();
+    releaseChain(std::move(head_));
+  }
+
+  iterator begin() { return iterator(head_.get()); }
+
+  iterator end() { return iterator(); }
+
+  const_iterator begin() const { return const_iterator(head_.get()); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  // Copies the values from head to tail.
+  std::vector<T> values() const { return std::vector<T>(begin(), end()); }
+
+  // Copies whole nodes, so every copied next_ link touches a reference count.
+  LIST_DEPRECATED("copies the node links, use values() or the iterators")
   std::vector<LinkedListNode<T>> toArray() const {
     std::vector<LinkedListNode<T>> nodes;
 
-    auto currentNode = head_;
-    while (currentNode) {
-      nodes.push_back(*currentNode);
-      currentNode = currentNode->next_;
+    for (auto it = begin(); it != end(); ++it) {
+      nodes.push_back(*it.node());
     }
 
     return nodes;
   }
 
-  std::string toString(std::function<std::string(const T&)> callback) const {
-    std::vector<LinkedListNode<T>> nodes = toArray();
+  // Writes the values separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeNodes(writer, [&](const LinkedListNode<T>& node) {
+      writer.write(node.value_);
+    });
+  }
 
-    std::string ret =
-        std::accumulate(nodes.begin(), nodes.end(), std::string(),
-                        [&](const std::string& a, const LinkedListNode<T>& b) {
-                          return a + std::string(",") + b.toString(callback);
-                        });
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeNodes(writer, [&](const LinkedListNode<T>& node) {
+      writer.write(node.toString(callback));
+    });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
 
-    return ret.length() ? ret.substr(1) : ret;
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
   }
 
   std::string toString() const {
-    std::vector<LinkedListNode<T>> nodes = toArray();
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  // Writes the values from head to tail as a SEQUENCE snapshot.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(std::distance(begin(), end())));
+    for (auto& value : *this) {
+      writer.write(value);
+    }
+  }
+
+  // Replaces the content of the list with the values of a SEQUENCE snapshot.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    clear();
+    for (std::uint64_t index = 0; index < count; ++index) {
+      emplaceAppend(reader.read<T>());
+    }
+  }
+
+ public:
+  const Stats& stats() const { return stats_; }
+
+  Allocator getAllocator() const { return allocator_; }
+
+ private:
+  // Links a chain of nodes after the tail.
+  void attach(std::shared_ptr<LinkedListNode<T>> head,
+              std::shared_ptr<LinkedListNode<T>> tail) {
+    if (tail_) {
+      tail_->next_ = std::move(head);
+    } else {
+      head_ = std::move(head);
+    }
+
+    tail_ = std::move(tail);
+  }
+
+  // Merges two sorted chains, taking from earlier on ties to keep the sort
+  // stable.
+  template <typename CustomCompare>
+  std::shared_ptr<LinkedListNode<T>> merge(
+      std::shared_ptr<LinkedListNode<T>> earlier,
+      std::shared_ptr<LinkedListNode<T>> later,
+      const Comparator<T, CustomCompare>& comparator) const {
+    std::shared_ptr<LinkedListNode<T>> head;
+    auto link = &head;
+
+    while (earlier && later) {
+      stats_.countComparison();
+      auto& next = comparator.lessThan(later->value_, earlier->value_)
+                       ? later
+                       : earlier;
+      *link = std::move(next);
+      next = std::move((*link)->next_);
+      link = &(*link)->next_;
+    }
 
-    std::string ret =
-        std::accumulate(nodes.begin(), nodes.end(), std::string(),
-                        [](const std::string& a, const LinkedListNode<T>& b) {
-                          return a + std::string(",") + b.toString();
-                        });
+    *link = earlier ? std::move(earlier) : std::move(later);
+    return head;
+  }
+
+  static void releaseChain(std::shared_ptr<LinkedListNode<T>> head) {
+    while (head && head.use_count() == 1) {
+      head = std::move(head->next_);
+    }
+  }
+
+  template <typename Writer, typename WriteNode>
+  Writer& writeNodes(Writer& writer, WriteNode writeNode) const {
+    for (auto it = begin(); it != end(); ++it) {
+      if (it != begin()) {
+        writer.write(',');
+      }
+
+      writeNode(*it.node());
+    }
+
+    return writer;
+  }
+
+  template <typename Callback>
+  std::shared_ptr<LinkedListNode<T>> findNode(Callback& callback) const {
+    // Walks the links themselves so that only the found node is copied.
+    for (auto link = &head_; *link; link = &(*link)->next_) {
+      stats_.countNodeVisit();
+
+      if (callback((*link)->value_)) {
+        return *link;
+      }
+    }
+
+    return nullptr;
+  }
 
-    return ret.length() ? ret.substr(1) : ret;
+  bool equal(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.equal(a, b);
   }
 
  public:
@@ -213,5 +493,7 @@ class LinkedList {
   std::shared_ptr<LinkedListNode<T>> tail_;
 
  private:
-  Comparator<T> comparator_;
+  Comparator<T, Compare> comparator_;
+  mutable Stats stats_;
+  Allocator allocator_;
 };
@@ -26,13 +26,27 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
 template <typename T>
 class LinkedListNode {
+ public:
+  // Selects the constructor that builds the value in place.
+  struct emplace_t {};
+
  public:
   explicit LinkedListNode(const T& value,
                           std::shared_ptr<LinkedListNode> next = nullptr)
-      : value_(value), next_(next) {}
+      : value_(value), next_(std::move(next)) {}
+
+  explicit LinkedListNode(T&& value,
+                          std::shared_ptr<LinkedListNode> next = nullptr)
+      : value_(std::move(value)), next_(std::move(next)) {}
+
+  template <typename... Args>
+  LinkedListNode(emplace_t, std::shared_ptr<LinkedListNode> next,
+                 Args&&... args)
+      : value_(std::forward<Args>(args)...), next_(std::move(next)) {}
 
   std::string toString(std::function<std::string(const T&)> callback) const {
     if (callback)
@@ -41,6 +55,12 @@ class LinkedListNode {
       return "LinkedListNode";
   }
 
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    return callback(value_);
+  }
+
   std::string toString() const {
     std::stringstream ss;
     ss << value_;
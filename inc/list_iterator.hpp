@@ -0,0 +1,104 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Marks list members that copy whole nodes, links included, and are only kept
+// for existing callers. [[deprecated]] needs C++14.
+#if __cplusplus >= 201402L
+#define LIST_DEPRECATED(message) [[deprecated(message)]]
+#else
+#define LIST_DEPRECATED(message) __attribute__((deprecated(message)))
+#endif
+
+// Forward iterator over the values of nodes linked through a next_ pointer,
+// such as LinkedListNode. next_ may be a shared_ptr or a plain pointer. It
+// holds a plain pointer to the current node, so walking a list neither
+// allocates nor touches the reference counts of the shared_ptr links. Node is
+// const for const iterators.
+template <typename Node, typename Value>
+class ListIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename std::remove_const<Value>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+
+ public:
+  ListIterator() : node_(nullptr) {}
+
+  explicit ListIterator(Node* node) : node_(node) {}
+
+  // Lets an iterator convert to a const iterator.
+  template <typename OtherNode, typename OtherValue,
+            typename = typename std::enable_if<
+                std::is_convertible<OtherNode*, Node*>::value>::type>
+  ListIterator(  // NOLINT(runtime/explicit)
+      const ListIterator<OtherNode, OtherValue>& other)
+      : node_(other.node()) {}
+
+  reference operator*() const { return node_->value_; }
+
+  pointer operator->() const { return &node_->value_; }
+
+  ListIterator& operator++() {
+    node_ = nodeOf(node_->next_);
+    return *this;
+  }
+
+  ListIterator operator++(int) {
+    auto previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  // The node holding the current value, null at the end.
+  Node* node() const { return node_; }
+
+  friend bool operator==(const ListIterator& a, const ListIterator& b) {
+    return a.node_ == b.node_;
+  }
+
+  friend bool operator!=(const ListIterator& a, const ListIterator& b) {
+    return a.node_ != b.node_;
+  }
+
+ private:
+  template <typename Next>
+  static Next* nodeOf(const std::shared_ptr<Next>& next) {
+    return next.get();
+  }
+
+  template <typename Next>
+  static Next* nodeOf(Next* next) {
+    return next;
+  }
+
+ private:
+  Node* node_;
+};
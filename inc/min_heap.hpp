@@ -23,19 +23,27 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <functional>
-#include <numeric>
-#include <sstream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 #include "comparator.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
 
-template <typename T>
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
 class MinHeap {
+ private:
+  using key_t = typename Comparator<T, Compare>::key_type;
+
  public:
-  explicit MinHeap(typename Comparator<T>::compare_func_t compare = nullptr)
-      : comparator_(compare) {}
+  explicit MinHeap(Compare compare = Compare(),
+                   const Allocator &allocator = Allocator())
+      : container_(allocator), keys_(allocator), comparator_(compare) {}
 
   const T *peek() const {
     if (container_.size() == 0) {
@@ -50,53 +58,184 @@ class MinHeap {
       return nullptr;
     }
 
+    // The polled element is moved into root_ so the returned pointer stays
+    // valid after it has been removed from the container.
+    root_ = std::move(container_[0]);
+
     if (container_.size() == 1) {
-      const T *back = &container_.back();
       container_.pop_back();
-      return back;
+      keys_.popBack();
+      return &root_;
     }
 
-    root_ = container_[0];
-
     // Move the last element from the end to the head.
-    container_[0] = container_.back();
+    container_[0] = std::move(container_.back());
     container_.pop_back();
+    keys_.moveBack(0);
     heapifyDown();
 
     return &root_;
   }
 
-  MinHeap &add(const T &item) {
-    container_.push_back(item);
+  MinHeap &add(const T &item) { return emplace(item); }
+
+  MinHeap &add(T &&item) { return emplace(std::move(item)); }
+
+  template <typename... Args>
+  MinHeap &emplace(Args &&... args) {
+    if (container_.size() == container_.capacity()) {
+      stats_.countAllocation();
+    }
+
+    container_.emplace_back(std::forward<Args>(args)...);
+    try {
+      keys_.pushBack(comparator_.policy(), container_.back());
+    } catch (...) {
+      container_.pop_back();
+      throw;
+    }
+
     heapifyUp();
     return *this;
   }
 
-  MinHeap &remove(const T &item, Comparator<T> comparator = Comparator<T>()) {
+  MinHeap &remove(const T &item) {
+    // Project the item once rather than on every search.
+    auto &&key = comparator_.key(item);
+    return removeFound([&]() { return findKey(key); });
+  }
+
+  template <typename CustomCompare>
+  MinHeap &remove(const T &item,
+                  const Comparator<T, CustomCompare> &customComparator) {
+    return removeFound([&]() { return find(item, customComparator); });
+  }
+
+  std::vector<int> find(const T &item) const {
+    return findKey(comparator_.key(item));
+  }
+
+  template <typename CustomCompare>
+  std::vector<int> find(const T &item,
+                        const Comparator<T, CustomCompare> &comparator) const {
+    std::vector<int> foundItemIndices;
+
+    for (int itemIndex = 0; itemIndex < container_.size(); ++itemIndex) {
+      if (comparator.equal(item, container_[itemIndex])) {
+        foundItemIndices.push_back(itemIndex);
+      }
+    }
+
+    return foundItemIndices;
+  }
+
+  bool isEmpty() const { return container_.empty(); }
+
+  // Writes the items in heap order as a HEAP snapshot.
+  void writeSnapshot(SnapshotWriter &writer) const {
+    writer.writeHeader(SnapshotKind::HEAP, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(container_.size()));
+    for (auto &item : container_) {
+      writer.write(item);
+    }
+  }
+
+  // Replaces the content of the heap with the items of a HEAP snapshot. The
+  // heap is rebuilt bottom-up in linear time, so the snapshot may have been
+  // taken with another comparator. The heap is left unchanged if the snapshot
+  // is malformed.
+  void readSnapshot(SnapshotReader &reader) {
+    readSnapshot(reader, comparator_.policy());
+  }
+
+  const Stats &stats() const { return stats_; }
+
+  // Writes the items in container order separated by commas into a
+  // StringWriter or a StreamWriter.
+  template <typename Writer>
+  Writer &write(Writer &writer) const {
+    for (int itemIndex = 0; itemIndex < container_.size(); ++itemIndex) {
+      if (itemIndex) {
+        writer.write(',');
+      }
+
+      writer.write(container_[itemIndex]);
+    }
+
+    return writer;
+  }
+
+  std::string toString() const {
+    // Every item takes at least one character and a separator.
+    StringWriter writer(container_.size() * 2);
+    return write(writer).release();
+  }
+
+ protected:
+  // Replaces the comparison policy, for derived heaps whose policy refers to
+  // their own state and has to be re-pointed after a copy or a move.
+  void setCompare(const Compare &compare) {
+    comparator_ = Comparator<T, Compare>(compare);
+    keys_.rebuild(compare, container_);
+  }
+
+  // Reads a HEAP snapshot like the public overload, but heapifies the items
+  // with compare instead of the current policy, for derived heaps whose
+  // policy only orders the loaded items once they commit their own state.
+  void readSnapshot(SnapshotReader &reader, const Compare &compare) {
+    reader.readHeader(SnapshotKind::HEAP, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    // The items and their cached keys are loaded and heapified in a local
+    // heap, then swapped in together.
+    MinHeap loaded(compare, container_.get_allocator());
+    loaded.stats_ = stats_;
+    loaded.container_.reserve(count);
+    for (std::uint64_t index = 0; index < count; ++index) {
+      loaded.container_.push_back(reader.read<T>());
+    }
+
+    if (count) {
+      loaded.stats_.countAllocation();
+    }
+    loaded.keys_.rebuild(compare, loaded.container_);
+    for (int index = static_cast<int>(count) / 2 - 1; index >= 0; --index) {
+      loaded.heapifyDown(index);
+    }
+
+    using std::swap;
+    swap(container_, loaded.container_);
+    swap(keys_, loaded.keys_);
+    stats_ = loaded.stats_;
+  }
+
+ private:
+  // Removes every item found by find, which is called again after each
+  // removal since indices change with every heapify.
+  template <typename Find>
+  MinHeap &removeFound(Find find) {
     // Find number of items to remove.
-    auto customComparator = comparator ? comparator : comparator_;
-    auto numberOfItemsToRemove = find(item, customComparator).size();
+    auto numberOfItemsToRemove = find().size();
 
     for (int iteration = 0; iteration < numberOfItemsToRemove; ++iteration) {
-      // We need to find item index to remove each time after removal since
-      // indices are being change after each heapify process.
-      auto indexToRemove = find(item, customComparator).back();
+      auto indexToRemove = find().back();
 
       // If we need to remove last child in the heap then just remove it.
       // There is no need to heapify the heap afterwards.
       if (indexToRemove == (container_.size() - 1)) {
         container_.pop_back();
+        keys_.popBack();
       } else {
         // Move last element in heap to the vacant (removed) position.
-        container_[indexToRemove] = container_.back();
+        container_[indexToRemove] = std::move(container_.back());
         container_.pop_back();
+        keys_.moveBack(indexToRemove);
 
         // If there is no parent or parent is less then node to delete then
         // heapify down. Otherwise heapify up.
         if (hasLeftChild(indexToRemove) &&
             (!hasParent(indexToRemove) ||
-             comparator_.lessThan(parent(indexToRemove),
-                                  container_[indexToRemove]))) {
+             lessThan(getParentIndex(indexToRemove), indexToRemove))) {
           heapifyDown(indexToRemove);
         } else {
           heapifyUp(indexToRemove);
@@ -107,13 +246,11 @@ class MinHeap {
     return *this;
   }
 
-  std::vector<int> find(
-      const T &item, Comparator<T> custom_comparator = Comparator<T>()) const {
+  std::vector<int> findKey(const key_t &key) const {
     std::vector<int> foundItemIndices;
-    auto comparator = custom_comparator ? custom_comparator : comparator_;
 
     for (int itemIndex = 0; itemIndex < container_.size(); ++itemIndex) {
-      if (comparator.equal(item, container_[itemIndex])) {
+      if (comparator_.compareKeys(key, keys_.at(container_, itemIndex)) == 0) {
         foundItemIndices.push_back(itemIndex);
       }
     }
@@ -121,21 +258,14 @@ class MinHeap {
     return foundItemIndices;
   }
 
-  bool isEmpty() const { return container_.empty(); }
-
-  std::string toString() const {
-    std::string ret =
-        std::accumulate(container_.begin(), container_.end(), std::string(),
-                        [](const std::string &a, const T &b) {
-                          std::stringstream ss;
-                          ss << a << "," << b;
-                          return ss.str();
-                        });
-
-    return ret.length() ? ret.substr(1) : ret;
+  // Compares the items at two indices through their cached keys, or the items
+  // themselves when the policy has no projection.
+  bool lessThan(int indexOne, int indexTwo) {
+    stats_.countComparison();
+    return comparator_.compareKeys(keys_.at(container_, indexOne),
+                                   keys_.at(container_, indexTwo)) < 0;
   }
 
- private:
   static int getLeftChildIndex(int parentIndex) {
     return (2 * parentIndex) + 1;
   }
@@ -160,22 +290,10 @@ class MinHeap {
     return getRightChildIndex(parentIndex) < container_.size();
   }
 
-  const T &leftChild(int parentIndex) const {
-    return container_[getLeftChildIndex(parentIndex)];
-  }
-
-  const T &rightChild(int parentIndex) const {
-    return container_[getRightChildIndex(parentIndex)];
-  }
-
-  const T &parent(int childIndex) const {
-    return container_[getParentIndex(childIndex)];
-  }
-
   void swap(int indexOne, int indexTwo) {
-    auto tmp = container_[indexTwo];
-    container_[indexTwo] = container_[indexOne];
-    container_[indexOne] = tmp;
+    using std::swap;
+    swap(container_[indexOne], container_[indexTwo]);
+    keys_.swap(indexOne, indexTwo);
   }
 
   void heapifyUp(int customStartIndex = -1) {
@@ -185,9 +303,8 @@ class MinHeap {
     auto currentIndex =
         (customStartIndex < 0) ? container_.size() - 1 : customStartIndex;
 
-    while (
-        hasParent(currentIndex) &&
-        comparator_.lessThan(container_[currentIndex], parent(currentIndex))) {
+    while (hasParent(currentIndex) &&
+           lessThan(currentIndex, getParentIndex(currentIndex))) {
       swap(currentIndex, getParentIndex(currentIndex));
       currentIndex = getParentIndex(currentIndex);
     }
@@ -201,15 +318,14 @@ class MinHeap {
 
     while (hasLeftChild(currentIndex)) {
       if (hasRightChild(currentIndex) &&
-          comparator_.lessThan(rightChild(currentIndex),
-                               leftChild(currentIndex))) {
+          lessThan(getRightChildIndex(currentIndex),
+                   getLeftChildIndex(currentIndex))) {
         nextIndex = getRightChildIndex(currentIndex);
       } else {
         nextIndex = getLeftChildIndex(currentIndex);
       }
 
-      if (comparator_.lessThan(container_[currentIndex],
-                               container_[nextIndex])) {
+      if (lessThan(currentIndex, nextIndex)) {
         break;
       }
 
@@ -219,7 +335,9 @@ class MinHeap {
   }
 
  private:
-  std::vector<T> container_;
-  Comparator<T> comparator_;
+  std::vector<T, Allocator> container_;
+  CachedKeys<T, Compare, Allocator> keys_;
+  Comparator<T, Compare> comparator_;
+  Stats stats_;
   T root_;
 };
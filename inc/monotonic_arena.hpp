@@ -0,0 +1,145 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bump allocator that hands out memory from large chunks and frees all of it
+// at once. Individual deallocations are no-ops, so everything allocated from
+// an arena lives until release() is called or the arena is destroyed.
+class MonotonicArena {
+ public:
+  explicit MonotonicArena(std::size_t chunk_size = 64 * 1024)
+      : chunk_size_(chunk_size),
+        chunks_(nullptr),
+        current_(nullptr),
+        end_(nullptr),
+        bytes_allocated_(0) {}
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+  ~MonotonicArena() { release(); }
+
+  void* allocate(std::size_t size, std::size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(current_);
+    auto aligned = (address + alignment - 1) & ~(alignment - 1);
+
+    if (!current_ || aligned + size > reinterpret_cast<std::uintptr_t>(end_)) {
+      grow(size + alignment);
+      address = reinterpret_cast<std::uintptr_t>(current_);
+      aligned = (address + alignment - 1) & ~(alignment - 1);
+    }
+
+    current_ = reinterpret_cast<char*>(aligned + size);
+    bytes_allocated_ += size;
+
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  // Frees every chunk. Objects still living in the arena must not be used
+  // afterwards.
+  void release() {
+    while (chunks_) {
+      auto next = chunks_->next_;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+
+    current_ = end_ = nullptr;
+    bytes_allocated_ = 0;
+  }
+
+  std::size_t bytesAllocated() const { return bytes_allocated_; }
+
+ private:
+  struct Chunk {
+    Chunk* next_;
+  };
+
+  void grow(std::size_t min_size) {
+    auto size = sizeof(Chunk) + std::max(chunk_size_, min_size);
+    auto chunk = static_cast<Chunk*>(::operator new(size));
+    chunk->next_ = chunks_;
+    chunks_ = chunk;
+
+    current_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = reinterpret_cast<char*>(chunk) + size;
+  }
+
+ private:
+  std::size_t chunk_size_;
+  Chunk* chunks_;
+  char* current_;
+  char* end_;
+  std::size_t bytes_allocated_;
+};
+
+// Standard allocator backed by a MonotonicArena. A default constructed
+// ArenaAllocator has no arena and falls back to the global heap.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+ public:
+  ArenaAllocator() : arena_(nullptr) {}
+
+  explicit ArenaAllocator(MonotonicArena* arena) : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT(runtime/explicit)
+      : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (!arena_) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, std::size_t) {
+    if (!arena_) {
+      ::operator delete(p);
+    }
+  }
+
+  MonotonicArena* arena() const { return arena_; }
+
+ private:
+  MonotonicArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return !(a == b);
+}
@@ -0,0 +1,234 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Bounded lock-free queue for any number of producer and consumer threads,
+// after Dmitry Vyukov's design. Every cell of the ring carries a sequence
+// number telling which lap of which side may use it next. Threads claim
+// positions by advancing a shared counter with a CAS and then own their cell
+// until they publish it through its sequence number, so producers and
+// consumers only meet at the cells they hand over. The ring is allocated
+// once at construction.
+template <typename T, typename Allocator = std::allocator<T>>
+class MpmcQueue {
+ public:
+  static const std::size_t CACHE_LINE_SIZE = 64;
+
+ public:
+  // The capacity is rounded up to a power of two, at least 2.
+  explicit MpmcQueue(std::size_t capacity,
+                     const Allocator& allocator = Allocator())
+      : enqueue_position_(0),
+        dequeue_position_(0),
+        capacity_(roundUp(capacity)),
+        allocator_(allocator) {
+    cells_ = cell_traits_t::allocate(allocator_, capacity_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      ::new (static_cast<void*>(cells_ + i)) Cell(i);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  // No other thread may use the queue anymore.
+  ~MpmcQueue() {
+    for (auto position = dequeue_position_.load();
+         position != enqueue_position_.load(); ++position) {
+      cellAt(position).value().~T();
+    }
+
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      cells_[i].~Cell();
+    }
+    cell_traits_t::deallocate(allocator_, cells_, capacity_);
+  }
+
+  // Returns false if the queue is full.
+  bool tryEnqueue(const T& value) { return tryEmplace(value); }
+
+  bool tryEnqueue(T&& value) { return tryEmplace(std::move(value)); }
+
+  template <typename... Args>
+  bool tryEmplace(Args&&... args) {
+    std::size_t position;
+    if (!claim(enqueue_position_, 0, 1, position)) {
+      return false;
+    }
+
+    auto& cell = cellAt(position);
+    ::new (cell.storage_) T(std::forward<Args>(args)...);
+    cell.sequence_.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Copies as many of the count values as there are free cells in a row,
+  // claimed together. Returns how many were enqueued.
+  std::size_t tryEnqueueBulk(const T* values, std::size_t count) {
+    std::size_t position;
+    count = claim(enqueue_position_, 0, count, position);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      auto& cell = cellAt(position + i);
+      ::new (cell.storage_) T(values[i]);
+      cell.sequence_.store(position + i + 1, std::memory_order_release);
+    }
+
+    return count;
+  }
+
+  // Moves the head into value. Returns false and leaves value alone if the
+  // queue is empty, or if the producer of the head has not published it
+  // yet.
+  bool tryDequeue(T& value) {
+    std::size_t position;
+    if (!claim(dequeue_position_, 1, 1, position)) {
+      return false;
+    }
+
+    release(position, value);
+    return true;
+  }
+
+  // Moves up to count values that are ready in a row, claimed together.
+  // Returns how many were moved.
+  std::size_t tryDequeueBulk(T* values, std::size_t count) {
+    std::size_t position;
+    count = claim(dequeue_position_, 1, count, position);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      release(position + i, values[i]);
+    }
+
+    return count;
+  }
+
+  // Exact only while no other thread uses the queue.
+  std::size_t size() const {
+    auto dequeuePosition = dequeue_position_.load(std::memory_order_acquire);
+    auto enqueuePosition = enqueue_position_.load(std::memory_order_acquire);
+    return enqueuePosition > dequeuePosition
+               ? enqueuePosition - dequeuePosition
+               : 0;
+  }
+
+  bool isEmpty() const { return !size(); }
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  struct Cell {
+    explicit Cell(std::size_t sequence) : sequence_(sequence) {}
+
+    T& value() { return *reinterpret_cast<T*>(storage_); }
+
+    // Equals the position of the next producer that may fill the cell, or
+    // the position plus one once the value is there for its consumer.
+    std::atomic<std::size_t> sequence_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+  };
+
+  using cell_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+  using cell_traits_t = std::allocator_traits<cell_allocator_t>;
+
+  static std::size_t roundUp(std::size_t capacity) {
+    std::size_t rounded = 2;
+    while (rounded < capacity) {
+      rounded *= 2;
+    }
+
+    return rounded;
+  }
+
+  Cell& cellAt(std::size_t position) {
+    return cells_[position & (capacity_ - 1)];
+  }
+
+  // How far the sequence of the cell for position is from being ready for
+  // the side whose cells carry position + lag.
+  std::intptr_t distance(std::size_t position, std::size_t lag) {
+    auto sequence = cellAt(position).sequence_.load(std::memory_order_acquire);
+    return static_cast<std::intptr_t>(sequence - (position + lag));
+  }
+
+  // Claims up to count cells in a row that are ready for one side, given by
+  // lag 0 for producers and 1 for consumers. Returns how many were claimed,
+  // the first one at position.
+  std::size_t claim(std::atomic<std::size_t>& counter, std::size_t lag,
+                    std::size_t count, std::size_t& position) {
+    position = counter.load(std::memory_order_relaxed);
+
+    while (count) {
+      auto first = distance(position, lag);
+      if (first < 0) {
+        // Full for producers, empty for consumers.
+        return 0;
+      }
+
+      if (first > 0) {
+        // Another thread has taken the cell, catch up.
+        position = counter.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      std::size_t ready = 1;
+      while (ready < count && !distance(position + ready, lag)) {
+        ++ready;
+      }
+
+      if (counter.compare_exchange_weak(position, position + ready,
+                                        std::memory_order_relaxed)) {
+        return ready;
+      }
+    }
+
+    return 0;
+  }
+
+  // Moves out the value of a claimed cell and hands the cell to the
+  // producer of the next lap.
+  void release(std::size_t position, T& value) {
+    auto& cell = cellAt(position);
+    value = std::move(cell.value());
+    cell.value().~T();
+    cell.sequence_.store(position + capacity_, std::memory_order_release);
+  }
+
+ private:
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_position_;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_position_;
+  alignas(CACHE_LINE_SIZE) Cell* cells_;
+  std::size_t capacity_;
+  cell_allocator_t allocator_;
+};
+
+template <typename T, typename Allocator>
+const std::size_t MpmcQueue<T, Allocator>::CACHE_LINE_SIZE;
@@ -0,0 +1,209 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Fixed size block allocator for list and tree nodes. Blocks are carved out of
+// large chunks and grouped in size classes. A freed block goes to the free
+// list of its class and is handed out again by the next allocation of that
+// class, so containers churning nodes stop hitting the global heap once the
+// pool has grown to their working set. Not thread safe.
+class NodePool {
+ public:
+  // Granularity and alignment of the blocks.
+  static const std::size_t BLOCK_ALIGNMENT = 16;
+  // Larger requests are not pooled.
+  static const std::size_t MAX_BLOCK_SIZE = 256;
+
+ public:
+  explicit NodePool(std::size_t chunk_size = 64 * 1024)
+      : chunk_size_(chunk_size < MAX_BLOCK_SIZE ? MAX_BLOCK_SIZE : chunk_size),
+        chunks_(nullptr),
+        current_(nullptr),
+        end_(nullptr),
+        chunk_count_(0),
+        blocks_in_use_(0) {
+    for (auto& freeList : free_lists_) {
+      freeList = nullptr;
+    }
+  }
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  ~NodePool() { release(); }
+
+  static bool pooled(std::size_t size, std::size_t alignment) {
+    return size && size <= MAX_BLOCK_SIZE && alignment <= BLOCK_ALIGNMENT;
+  }
+
+  // size must be pooled.
+  void* allocate(std::size_t size) {
+    auto sizeClass = classOf(size);
+    ++blocks_in_use_;
+
+    auto block = free_lists_[sizeClass];
+    if (block) {
+      free_lists_[sizeClass] = block->next_;
+      return block;
+    }
+
+    auto blockSize = (sizeClass + 1) * BLOCK_ALIGNMENT;
+    if (static_cast<std::size_t>(end_ - current_) < blockSize) {
+      grow();
+    }
+
+    auto address = current_;
+    current_ += blockSize;
+    return address;
+  }
+
+  // Hands a block back to the free list of its class. size must be the size
+  // the block has been allocated with.
+  void deallocate(void* p, std::size_t size) {
+    auto block = static_cast<FreeBlock*>(p);
+    auto sizeClass = classOf(size);
+    block->next_ = free_lists_[sizeClass];
+    free_lists_[sizeClass] = block;
+    --blocks_in_use_;
+  }
+
+  // Frees every chunk. Blocks still in use must not be touched afterwards.
+  void release() {
+    while (chunks_) {
+      auto next = chunks_->next_;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+
+    for (auto& freeList : free_lists_) {
+      freeList = nullptr;
+    }
+
+    current_ = end_ = nullptr;
+    chunk_count_ = 0;
+    blocks_in_use_ = 0;
+  }
+
+  std::size_t chunkCount() const { return chunk_count_; }
+
+  std::size_t blocksInUse() const { return blocks_in_use_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  // Chunk headers are padded so that the blocks following them stay aligned.
+  union Chunk {
+    Chunk* next_;
+    alignas(BLOCK_ALIGNMENT) char padding_[BLOCK_ALIGNMENT];
+  };
+
+  static const std::size_t CLASS_COUNT = MAX_BLOCK_SIZE / BLOCK_ALIGNMENT;
+
+  static std::size_t classOf(std::size_t size) {
+    return (size - 1) / BLOCK_ALIGNMENT;
+  }
+
+  // Starts carving blocks out of a new chunk. The tail of the previous chunk
+  // is smaller than the requested block and is given up.
+  void grow() {
+    auto chunk =
+        static_cast<Chunk*>(::operator new(sizeof(Chunk) + chunk_size_));
+    chunk->next_ = chunks_;
+    chunks_ = chunk;
+    ++chunk_count_;
+
+    current_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = current_ + chunk_size_;
+  }
+
+ private:
+  std::size_t chunk_size_;
+  Chunk* chunks_;
+  char* current_;
+  char* end_;
+  FreeBlock* free_lists_[CLASS_COUNT];
+  std::size_t chunk_count_;
+  std::size_t blocks_in_use_;
+};
+
+// Standard allocator backed by a NodePool. Single objects small enough for
+// the pool, such as the nodes of LinkedList and the trees, are pooled. Arrays
+// and a default constructed PoolAllocator, which has no pool, use the global
+// heap.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+ public:
+  PoolAllocator() : pool_(nullptr) {}
+
+  explicit PoolAllocator(NodePool* pool) : pool_(pool) {}
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other)  // NOLINT(runtime/explicit)
+      : pool_(other.pool()) {}
+
+  T* allocate(std::size_t n) {
+    if (!pooled(n)) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    return static_cast<T*>(pool_->allocate(sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    if (!pooled(n)) {
+      ::operator delete(p);
+      return;
+    }
+
+    pool_->deallocate(p, sizeof(T));
+  }
+
+  NodePool* pool() const { return pool_; }
+
+ private:
+  bool pooled(std::size_t n) const {
+    return pool_ && n == 1 && NodePool::pooled(sizeof(T), alignof(T));
+  }
+
+ private:
+  NodePool* pool_;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+  return a.pool() == b.pool();
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) {
+  return !(a == b);
+}
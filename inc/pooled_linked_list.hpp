@@ -0,0 +1,394 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "comparator.hpp"
+#include "list_iterator.hpp"
+#include "node_pool.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
+
+// Singly linked list that owns its nodes through plain next_ pointers and
+// takes them from a NodePool through PoolAllocator. A node is one pooled
+// block holding the value and the link, with no shared_ptr control block,
+// and linking or unlinking it touches no reference count. In exchange nodes
+// never leave the list: find returns a pointer to the value, valid until the
+// value is removed, and deleteHead moves the value out.
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats,
+          typename Allocator = PoolAllocator<T>>
+class PooledLinkedList {
+ private:
+  struct Node;
+
+ public:
+  using iterator = ListIterator<Node, T>;
+  using const_iterator = ListIterator<const Node, const T>;
+
+ public:
+  explicit PooledLinkedList(Compare compare = Compare(),
+                            const Allocator& allocator = Allocator())
+      : head_(nullptr),
+        tail_(nullptr),
+        size_(0),
+        comparator_(compare),
+        allocator_(allocator) {}
+
+  PooledLinkedList(const PooledLinkedList& other)
+      : head_(nullptr),
+        tail_(nullptr),
+        size_(0),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    try {
+      for (auto& value : other) {
+        emplaceAppend(value);
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  PooledLinkedList(PooledLinkedList&& other)
+      : head_(other.head_),
+        tail_(other.tail_),
+        size_(other.size_),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    other.head_ = other.tail_ = nullptr;
+    other.size_ = 0;
+  }
+
+  PooledLinkedList& operator=(PooledLinkedList other) {
+    swap(other);
+    return *this;
+  }
+
+  ~PooledLinkedList() { clear(); }
+
+  void swap(PooledLinkedList& other) {
+    using std::swap;
+    swap(head_, other.head_);
+    swap(tail_, other.tail_);
+    swap(size_, other.size_);
+    swap(stats_, other.stats_);
+    swap(comparator_, other.comparator_);
+    swap(allocator_, other.allocator_);
+  }
+
+  PooledLinkedList& prepend(const T& value) { return emplacePrepend(value); }
+
+  PooledLinkedList& prepend(T&& value) {
+    return emplacePrepend(std::move(value));
+  }
+
+  PooledLinkedList& append(const T& value) { return emplaceAppend(value); }
+
+  PooledLinkedList& append(T&& value) {
+    return emplaceAppend(std::move(value));
+  }
+
+  template <typename... Args>
+  PooledLinkedList& emplacePrepend(Args&&... args) {
+    auto node = makeNode(std::forward<Args>(args)...);
+    node->next_ = head_;
+    head_ = node;
+    if (!tail_) {
+      tail_ = node;
+    }
+
+    ++size_;
+    return *this;
+  }
+
+  template <typename... Args>
+  PooledLinkedList& emplaceAppend(Args&&... args) {
+    auto node = makeNode(std::forward<Args>(args)...);
+    if (tail_) {
+      tail_->next_ = node;
+    } else {
+      head_ = node;
+    }
+    tail_ = node;
+
+    ++size_;
+    return *this;
+  }
+
+  // Removes every value equal to the given one and returns how many were
+  // removed.
+  std::size_t remove(const T& value) {
+    // The value may be one of the list's own, which is freed during the
+    // scan, so the scan compares against a copy.
+    const T removedValue(value);
+    std::size_t removed = 0;
+    Node* previousNode = nullptr;
+
+    for (auto link = &head_; *link;) {
+      auto node = *link;
+      if (equal(node->value_, removedValue)) {
+        *link = node->next_;
+        freeNode(node);
+        ++removed;
+      } else {
+        previousNode = node;
+        link = &node->next_;
+      }
+    }
+
+    tail_ = previousNode;
+    size_ -= removed;
+    return removed;
+  }
+
+  const T* find(const T& value) const {
+    return find([&](const T& test) { return equal(test, value); });
+  }
+
+  const T* find(std::function<bool(const T&)> callback) const {
+    if (!callback) {
+      return nullptr;
+    }
+
+    return findValue(callback);
+  }
+
+  // Same as above but keeps the type of the callback so that it can be
+  // inlined instead of being called through std::function.
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  const T* find(Callback&& callback) const {
+    return findValue(callback);
+  }
+
+  // Removes the first value, moving it into value when given. Returns false
+  // if the list is empty.
+  bool deleteHead(T* value = nullptr) {
+    if (!head_) {
+      return false;
+    }
+
+    auto node = head_;
+    if (value) {
+      *value = std::move(node->value_);
+    }
+
+    head_ = node->next_;
+    if (!head_) {
+      tail_ = nullptr;
+    }
+    freeNode(node);
+
+    --size_;
+    return true;
+  }
+
+  const T* head() const { return head_ ? &head_->value_ : nullptr; }
+
+  const T* tail() const { return tail_ ? &tail_->value_ : nullptr; }
+
+  bool isEmpty() const { return !size_; }
+
+  std::size_t size() const { return size_; }
+
+  void clear() {
+    while (head_) {
+      auto node = head_;
+      head_ = node->next_;
+      freeNode(node);
+    }
+
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+  iterator begin() { return iterator(head_); }
+
+  iterator end() { return iterator(); }
+
+  const_iterator begin() const { return const_iterator(head_); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  // Copies the values from head to tail.
+  std::vector<T> values() const {
+    std::vector<T> result;
+    result.reserve(size_);
+    result.assign(begin(), end());
+    return result;
+  }
+
+  // Writes the values separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeValues(writer, [&](const T& value) { writer.write(value); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeValues(writer,
+                       [&](const T& value) { writer.write(callback(value)); });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  // Writes the values from head to tail as a SEQUENCE snapshot, the same
+  // format as LinkedList.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(size_));
+    for (auto& value : *this) {
+      writer.write(value);
+    }
+  }
+
+  // Replaces the content of the list with the values of a SEQUENCE snapshot.
+  // The list is left unchanged if the snapshot is malformed.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    PooledLinkedList loaded(comparator_.policy(), allocator_);
+    loaded.stats_ = stats_;
+    for (std::uint64_t index = 0; index < count; ++index) {
+      loaded.emplaceAppend(reader.read<T>());
+    }
+
+    using std::swap;
+    swap(head_, loaded.head_);
+    swap(tail_, loaded.tail_);
+    swap(size_, loaded.size_);
+    stats_ = loaded.stats_;
+  }
+
+ public:
+  const Stats& stats() const { return stats_; }
+
+  Allocator getAllocator() const { return allocator_; }
+
+ private:
+  struct Node {
+    template <typename... Args>
+    explicit Node(Args&&... args)
+        : value_(std::forward<Args>(args)...), next_(nullptr) {}
+
+    T value_;
+    Node* next_;
+  };
+
+  using node_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits_t = std::allocator_traits<node_allocator_t>;
+
+  template <typename... Args>
+  Node* makeNode(Args&&... args) {
+    stats_.countAllocation();
+    node_allocator_t allocator(allocator_);
+    auto node = node_traits_t::allocate(allocator, 1);
+
+    try {
+      ::new (static_cast<void*>(node)) Node(std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits_t::deallocate(allocator, node, 1);
+      throw;
+    }
+
+    return node;
+  }
+
+  void freeNode(Node* node) {
+    node_allocator_t allocator(allocator_);
+    node->~Node();
+    node_traits_t::deallocate(allocator, node, 1);
+  }
+
+  template <typename Writer, typename WriteValue>
+  Writer& writeValues(Writer& writer, WriteValue writeValue) const {
+    for (auto node = head_; node; node = node->next_) {
+      if (node != head_) {
+        writer.write(',');
+      }
+
+      writeValue(node->value_);
+    }
+
+    return writer;
+  }
+
+  template <typename Callback>
+  const T* findValue(Callback& callback) const {
+    for (auto node = head_; node; node = node->next_) {
+      stats_.countNodeVisit();
+
+      if (callback(node->value_)) {
+        return &node->value_;
+      }
+    }
+
+    return nullptr;
+  }
+
+  bool equal(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.equal(a, b);
+  }
+
+ private:
+  Node* head_;
+  Node* tail_;
+  std::size_t size_;
+  Comparator<T, Compare> comparator_;
+  mutable Stats stats_;
+  Allocator allocator_;
+};
@@ -22,61 +22,153 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #include "min_heap.hpp"
 
-template <typename T>
-class PriorityQueue : public MinHeap<T> {
+// Orders items by the priority recorded for them in a priority map.
+template <typename T, typename Priorities = std::map<T, int>>
+class PriorityCompare {
  public:
-  PriorityQueue()
-      : MinHeap<T>(std::bind(&PriorityQueue::comparePriority, this,
-                             std::placeholders::_1, std::placeholders::_2)) {}
+  explicit PriorityCompare(const Priorities *priorities = nullptr)
+      : priorities_(priorities) {}
+
+  int operator()(const T &a, const T &b) const {
+    auto priorityA = priorities_->at(a);
+    auto priorityB = priorities_->at(b);
+    if (priorityA == priorityB) return 0;
+
+    return priorityA < priorityB ? -1 : 1;
+  }
+
+ private:
+  const Priorities *priorities_;
+};
+
+// Priorities of the items in a PriorityQueue, allocated like the queue.
+template <typename T, typename Allocator>
+using priority_map_t =
+    std::map<T, int, std::less<T>,
+             typename std::allocator_traits<
+                 Allocator>::template rebind_alloc<std::pair<const T, int>>>;
+
+template <typename T, typename Stats = NoStats,
+          typename Allocator = std::allocator<T>>
+class PriorityQueue
+    : public MinHeap<T, PriorityCompare<T, priority_map_t<T, Allocator>>,
+                     Stats, Allocator> {
+ public:
+  using priorities_t = priority_map_t<T, Allocator>;
+  using heap_t =
+      MinHeap<T, PriorityCompare<T, priorities_t>, Stats, Allocator>;
+
+ public:
+  explicit PriorityQueue(const Allocator &allocator = Allocator())
+      : heap_t(PriorityCompare<T, priorities_t>(&priorities_), allocator),
+        priorities_(allocator) {}
+
+  // The heap orders its items through a pointer to priorities_, so copies
+  // and moves point it back at their own priorities.
+  PriorityQueue(const PriorityQueue &other)
+      : heap_t(other), priorities_(other.priorities_) {
+    heap_t::setCompare(PriorityCompare<T, priorities_t>(&priorities_));
+  }
+
+  PriorityQueue(PriorityQueue &&other)
+      : heap_t(std::move(other)), priorities_(std::move(other.priorities_)) {
+    heap_t::setCompare(PriorityCompare<T, priorities_t>(&priorities_));
+  }
+
+  PriorityQueue &operator=(PriorityQueue other) {
+    heap_t::operator=(std::move(other));
+    priorities_ = std::move(other.priorities_);
+    heap_t::setCompare(PriorityCompare<T, priorities_t>(&priorities_));
+
+    return *this;
+  }
 
   PriorityQueue &add(const T &item, int priority = 0) {
     priorities_[item] = priority;
-    MinHeap<T>::add(item);
+    heap_t::add(item);
+
+    return *this;
+  }
+
+  PriorityQueue &remove(const T &item) {
+    heap_t::remove(item);
+    priorities_.erase(item);
 
     return *this;
   }
 
-  PriorityQueue &remove(const T &item, Comparator<T> comparator = nullptr) {
-    MinHeap<T>::remove(item, comparator);
+  template <typename CustomCompare>
+  PriorityQueue &remove(const T &item,
+                        const Comparator<T, CustomCompare> &comparator) {
+    heap_t::remove(item, comparator);
     priorities_.erase(item);
 
     return *this;
   }
 
   PriorityQueue &changePriority(const T &item, int priority) {
-    remove(item, Comparator<T>(std::bind(&PriorityQueue::compareValue, this,
-                                         std::placeholders::_1,
-                                         std::placeholders::_2)));
+    remove(item, Comparator<T>());
     add(item, priority);
 
     return *this;
   }
 
   std::vector<int> findByValue(const T &item) const {
-    return this->find(item, Comparator<T>(std::bind(
-                                &PriorityQueue::compareValue, this,
-                                std::placeholders::_1, std::placeholders::_2)));
+    return this->find(item, Comparator<T>());
   }
 
   bool hasValue(const T &item) const { return findByValue(item).size() > 0; }
 
- private:
-  int comparePriority(const T &a, const T &b) const {
-    if (priorities_.at(a) == priorities_.at(b)) return 0;
-
-    return priorities_.at(a) < priorities_.at(b) ? -1 : 1;
+  // Writes a PRIORITY_QUEUE snapshot: the priority of every item followed by
+  // a HEAP snapshot of the items.
+  void writeSnapshot(SnapshotWriter &writer) const {
+    writer.writeHeader(SnapshotKind::PRIORITY_QUEUE,
+                       SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(priorities_.size()));
+    for (auto &priority : priorities_) {
+      writer.write(priority.first);
+      writer.write(static_cast<std::int32_t>(priority.second));
+    }
+
+    heap_t::writeSnapshot(writer);
   }
 
-  int compareValue(const T &a, const T &b) const {
-    if (a == b) return 0;
-
-    return a < b ? -1 : 1;
+  // Replaces the content of the queue with a PRIORITY_QUEUE snapshot. The
+  // priorities are restored first since the heap is ordered by them. The
+  // queue is left unchanged if the snapshot is malformed.
+  void readSnapshot(SnapshotReader &reader) {
+    reader.readHeader(SnapshotKind::PRIORITY_QUEUE,
+                      SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size +
+                                  sizeof(std::int32_t));
+
+    priorities_t loaded(priorities_.get_allocator());
+    for (std::uint64_t index = 0; index < count; ++index) {
+      auto item = reader.read<T>();
+      loaded.emplace_hint(loaded.end(), std::move(item),
+                          reader.read<std::int32_t>());
+    }
+
+    // The heap is loaded in order of the local priorities, and both are only
+    // swapped in once the whole snapshot has been read.
+    try {
+      heap_t::readSnapshot(reader, PriorityCompare<T, priorities_t>(&loaded));
+    } catch (const std::out_of_range &) {
+      // Rebuilding the heap looked up an item without a priority.
+      throw SnapshotError("snapshot item has no priority");
+    }
+    priorities_.swap(loaded);
   }
 
  private:
-  std::map<T, int> priorities_;
+  priorities_t priorities_;
 };
@@ -22,35 +22,342 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
 #include <string>
-#include "linked_list.hpp"
+#include <utility>
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
 
-template <typename T>
+// FIFO queue on a ring buffer. The capacity is a power of two and doubles
+// when the buffer is full, so once the queue has grown to its working set
+// enqueue and dequeue neither allocate nor free. Bulk operations copy whole
+// runs of the buffer at once.
+template <typename T, typename Stats = NoStats,
+          typename Allocator = std::allocator<T>>
 class Queue {
  public:
-  bool isEmpty() const { return !linked_list_.tail_; }
+  // Capacity of the first buffer.
+  static const std::size_t MIN_CAPACITY = 16;
+
+ public:
+  explicit Queue(const Allocator& allocator = Allocator())
+      : buffer_(nullptr),
+        capacity_(0),
+        head_(0),
+        size_(0),
+        allocator_(allocator) {}
+
+  Queue(const Queue& other)
+      : buffer_(nullptr),
+        capacity_(0),
+        head_(0),
+        size_(0),
+        allocator_(other.allocator_) {
+    reserve(other.size_);
+    for (std::size_t i = 0; i < other.size_; ++i) {
+      emplace(other.at(i));
+    }
+  }
+
+  Queue(Queue&& other)
+      : buffer_(other.buffer_),
+        capacity_(other.capacity_),
+        head_(other.head_),
+        size_(other.size_),
+        allocator_(other.allocator_) {
+    other.buffer_ = nullptr;
+    other.capacity_ = other.head_ = other.size_ = 0;
+  }
+
+  Queue& operator=(Queue other) {
+    swap(other);
+    return *this;
+  }
+
+  ~Queue() {
+    clear();
+    freeBuffer();
+  }
+
+  void swap(Queue& other) {
+    using std::swap;
+    swap(buffer_, other.buffer_);
+    swap(capacity_, other.capacity_);
+    swap(head_, other.head_);
+    swap(size_, other.size_);
+    swap(stats_, other.stats_);
+    swap(allocator_, other.allocator_);
+  }
+
+  bool isEmpty() const { return !size_; }
+
+  std::size_t size() const { return size_; }
+
+  std::size_t capacity() const { return capacity_; }
 
   const T* peek() const {
-    if (!linked_list_.head_) {
+    if (!size_) {
       return nullptr;
     }
 
-    return &linked_list_.head_->value_;
+    return &buffer_[head_];
+  }
+
+  void enqueue(const T& value) { emplace(value); }
+
+  void enqueue(T&& value) { emplace(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    if (size_ < capacity_) {
+      construct(&at(size_), std::forward<Args>(args)...);
+      ++size_;
+      return;
+    }
+
+    // The new value is built before the old ones move, args may refer to
+    // one of them.
+    auto capacity = capacity_ ? 2 * capacity_ : MIN_CAPACITY;
+    auto buffer = allocateBuffer(capacity);
+    try {
+      construct(buffer + size_, std::forward<Args>(args)...);
+    } catch (...) {
+      deallocateBuffer(buffer, capacity);
+      throw;
+    }
+
+    moveTo(buffer, capacity, true);
+    ++size_;
   }
 
-  void enqueue(const T& value) { linked_list_.append(value); }
+  // Copies count values in order, growing the buffer at most once.
+  void enqueueBulk(const T* values, std::size_t count) {
+    reserve(size_ + count);
+
+    // The free space wraps around the end of the buffer at most once.
+    auto tail = (head_ + size_) & mask();
+    auto first = std::min(count, capacity_ - tail);
+    std::uninitialized_copy(values, values + first, buffer_ + tail);
+    size_ += first;
+    std::uninitialized_copy(values + first, values + count, buffer_);
+    size_ += count - first;
+  }
 
+  // Returns T() if the queue is empty, use tryDequeue to tell it apart.
   T dequeue() {
-    auto removedHead = linked_list_.deleteHead();
-    return removedHead ? removedHead->value_ : T();
+    if (!size_) {
+      return T();
+    }
+
+    T value(std::move(buffer_[head_]));
+    popFront();
+    return value;
+  }
+
+  // Moves the head into value, which is a T or anything a T can be assigned
+  // to, such as an optional. Returns false and leaves value alone if the
+  // queue is empty.
+  template <typename Value>
+  bool tryDequeue(Value& value) {
+    if (!size_) {
+      return false;
+    }
+
+    value = std::move(buffer_[head_]);
+    popFront();
+    return true;
+  }
+
+  // Moves up to count values from the head into values. Returns how many
+  // were moved.
+  std::size_t dequeueBulk(T* values, std::size_t count) {
+    count = std::min(count, size_);
+
+    auto first = std::min(count, capacity_ - head_);
+    std::move(buffer_ + head_, buffer_ + head_ + first, values);
+    std::move(buffer_, buffer_ + count - first, values + first);
+    destroy(head_, count);
+
+    head_ = (head_ + count) & mask();
+    size_ -= count;
+    if (!size_) {
+      head_ = 0;
+    }
+
+    return count;
+  }
+
+  // Grows the buffer to hold at least capacity values.
+  void reserve(std::size_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+
+    auto newCapacity = capacity_ ? capacity_ : MIN_CAPACITY;
+    while (newCapacity < capacity) {
+      newCapacity *= 2;
+    }
+
+    moveTo(allocateBuffer(newCapacity), newCapacity, false);
+  }
+
+  // Keeps the buffer, so refilling the queue does not allocate.
+  void clear() {
+    destroy(head_, size_);
+    head_ = size_ = 0;
+  }
+
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(size_));
+    for (std::size_t i = 0; i < size_; ++i) {
+      writer.write(at(i));
+    }
+  }
+
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    clear();
+    for (std::uint64_t index = 0; index < count; ++index) {
+      emplace(reader.read<T>());
+    }
+  }
+
+  // Writes the values from head to tail separated by commas.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeValues(writer, [&](const T& value) { writer.write(value); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeValues(writer,
+                       [&](const T& value) { writer.write(callback(value)); });
   }
 
   std::string toString(std::function<std::string(const T&)> callback) const {
-    return linked_list_.toString(callback);
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  using traits_t = std::allocator_traits<Allocator>;
+
+  std::size_t mask() const { return capacity_ - 1; }
+
+  // The value index places behind the head.
+  T& at(std::size_t index) { return buffer_[(head_ + index) & mask()]; }
+
+  const T& at(std::size_t index) const {
+    return buffer_[(head_ + index) & mask()];
+  }
+
+  template <typename... Args>
+  static void construct(T* address, Args&&... args) {
+    ::new (static_cast<void*>(address)) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys count values starting at the slot first.
+  void destroy(std::size_t first, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      buffer_[(first + i) & mask()].~T();
+    }
+  }
+
+  void popFront() {
+    buffer_[head_].~T();
+    head_ = (head_ + 1) & mask();
+    if (!--size_) {
+      head_ = 0;
+    }
+  }
+
+  T* allocateBuffer(std::size_t capacity) {
+    stats_.countAllocation();
+    return traits_t::allocate(allocator_, capacity);
   }
 
-  std::string toString() const { return linked_list_.toString(); }
+  void deallocateBuffer(T* buffer, std::size_t capacity) {
+    traits_t::deallocate(allocator_, buffer, capacity);
+  }
+
+  void freeBuffer() {
+    if (buffer_) {
+      deallocateBuffer(buffer_, capacity_);
+      buffer_ = nullptr;
+    }
+  }
+
+  // Moves the values to the front of buffer, which replaces the current
+  // buffer. If hasNewValue, the slot behind them holds a value already that
+  // is destroyed with buffer when a move throws.
+  void moveTo(T* buffer, std::size_t capacity, bool hasNewValue) {
+    std::size_t moved = 0;
+    try {
+      for (; moved < size_; ++moved) {
+        construct(buffer + moved, std::move_if_noexcept(at(moved)));
+      }
+    } catch (...) {
+      for (std::size_t i = 0; i < moved; ++i) {
+        buffer[i].~T();
+      }
+      if (hasNewValue) {
+        buffer[size_].~T();
+      }
+      deallocateBuffer(buffer, capacity);
+      throw;
+    }
+
+    destroy(head_, size_);
+    freeBuffer();
+    buffer_ = buffer;
+    capacity_ = capacity;
+    head_ = 0;
+  }
+
+  template <typename Writer, typename WriteValue>
+  Writer& writeValues(Writer& writer, WriteValue writeValue) const {
+    for (std::size_t i = 0; i < size_; ++i) {
+      if (i) {
+        writer.write(',');
+      }
+
+      writeValue(at(i));
+    }
+
+    return writer;
+  }
 
  private:
-  LinkedList<T> linked_list_;
+  T* buffer_;
+  std::size_t capacity_;
+  std::size_t head_;
+  std::size_t size_;
+  Stats stats_;
+  Allocator allocator_;
 };
+
+template <typename T, typename Stats, typename Allocator>
+const std::size_t Queue<T, Stats, Allocator>::MIN_CAPACITY;
@@ -24,34 +24,45 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include "binary_search_tree.hpp"
 
-template <typename T>
-class RedBlackTree : public BinarySearchTree<T> {
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class RedBlackTree : public BinarySearchTree<T, Compare, Stats, Allocator> {
  public:
+  using tree_t = BinarySearchTree<T, Compare, Stats, Allocator>;
+  using node_t = typename tree_t::node_t;
+
+ public:
+  explicit RedBlackTree(Compare compare = Compare(),
+                        const Allocator& allocator = Allocator())
+      : tree_t(compare, allocator) {}
+
   const std::string RED = "red";
   const std::string BLACK = "black";
   const std::string COLOR = "color";
 
  public:
   BinaryTreeNode<T>& insert(const T& value) {
-    auto& result = BinarySearchTree<T>::insert(value);
+    return balanceFromInserted(tree_t::insert(value));
+  }
 
-    auto insertNode = result.shared_from_this();
+  BinaryTreeNode<T>& insert(T&& value) {
+    return balanceFromInserted(tree_t::insert(std::move(value)));
+  }
 
-    if (insertNode == this->root_) {
-      makeNodeBlack(insertNode);
-    } else {
-      makeNodeRed(insertNode);
-    }
+  bool remove(const T& value) { throw MethodNotImplementedException(); }
 
-    balance(insertNode);
+  void readSnapshot(SnapshotReader& reader) {
+    tree_t::readSnapshot(reader);
 
-    return result;
+    // The tree built from a snapshot is perfectly balanced, so all of its
+    // leaves are on the two deepest levels. Coloring the deepest level red
+    // and every other node black gives all paths the same black height.
+    colorBalanced(this->root_, 0, this->root_->height());
   }
 
-  bool remove(const T& value) { throw MethodNotImplementedException(); }
-
   bool isNodeRed(const BinaryTreeNode<T>& node) const {
     return *node.meta_.get(COLOR) == RED;
   }
@@ -65,6 +76,36 @@ class RedBlackTree : public BinarySearchTree<T> {
   }
 
  private:
+  void colorBalanced(std::shared_ptr<BinaryTreeNode<T>> node, int depth,
+                     int height) {
+    if (!node) {
+      return;
+    }
+
+    if (depth > 0 && depth == height) {
+      makeNodeRed(node);
+    } else {
+      makeNodeBlack(node);
+    }
+
+    colorBalanced(node->left_, depth + 1, height);
+    colorBalanced(node->right_, depth + 1, height);
+  }
+
+  BinaryTreeNode<T>& balanceFromInserted(node_t& result) {
+    auto insertNode = result.shared_from_this();
+
+    if (insertNode == this->root_) {
+      makeNodeBlack(insertNode);
+    } else {
+      makeNodeRed(insertNode);
+    }
+
+    balance(insertNode);
+
+    return result;
+  }
+
   void balance(std::shared_ptr<BinaryTreeNode<T>> node) {
     // If it is a root node then nothing to balance here.
     if (node == this->root_) {
@@ -130,7 +171,7 @@ class RedBlackTree : public BinarySearchTree<T> {
 
         // Set newGrandParent as a root if it doesn't have parent.
         if (newGrandParent && newGrandParent->parent_.lock() == nullptr) {
-          this->root_ = std::static_pointer_cast<BinarySearchTreeNode<T>>(
+          this->root_ = std::static_pointer_cast<node_t>(
               newGrandParent->shared_from_this());
 
           // Recolor root into black.
@@ -145,6 +186,8 @@ class RedBlackTree : public BinarySearchTree<T> {
 
   std::shared_ptr<BinaryTreeNode<T>> leftLeftRotation(
       std::shared_ptr<BinaryTreeNode<T>> grandParentNode) {
+    this->stats_.countRotation();
+
     // Memorize the parent of grand-parent node.
     auto grandGrandParent = grandParentNode->parent_.lock();
 
@@ -188,6 +231,8 @@ class RedBlackTree : public BinarySearchTree<T> {
 
   std::shared_ptr<BinaryTreeNode<T>> leftRightRotation(
       std::shared_ptr<BinaryTreeNode<T>> grandParentNode) {
+    this->stats_.countRotation();
+
     // Memorize left and left-right nodes.
     auto parentNode = grandParentNode->left_;
     auto childNode = parentNode->right_;
@@ -212,6 +257,8 @@ class RedBlackTree : public BinarySearchTree<T> {
 
   std::shared_ptr<BinaryTreeNode<T>> rightRightRotation(
       std::shared_ptr<BinaryTreeNode<T>> grandParentNode) {
+    this->stats_.countRotation();
+
     // Memorize the parent of grand-parent node.
     auto grandGrandParent = grandParentNode->parent_.lock();
 
@@ -255,6 +302,8 @@ class RedBlackTree : public BinarySearchTree<T> {
 
   std::shared_ptr<BinaryTreeNode<T>> rightLeftRotation(
       std::shared_ptr<BinaryTreeNode<T>> grandParentNode) {
+    this->stats_.countRotation();
+
     // Memorize right and right-left nodes.
     auto parentNode = grandParentNode->right_;
     auto childNode = parentNode->left_;
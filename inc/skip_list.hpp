@@ -0,0 +1,397 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "comparator.hpp"
+#include "list_iterator.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
+
+// Ordered set on a linked list whose nodes carry towers of forward links.
+// The bottom level links every node in order, like LinkedList, and each level
+// above skips about three quarters of the nodes of the level below, so
+// insert, remove, find and lowerBound take expected O(log n) steps. Links are
+// plain pointers and a node is allocated in one piece with its tower.
+template <typename T, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class SkipList {
+  struct Node;
+
+ public:
+  // Levels drawn from one 32 bit random number, enough for 4^16 values.
+  static const std::size_t MAX_HEIGHT = 16;
+
+  // Values order the list, so they are never handed out mutable.
+  using iterator = ListIterator<const Node, const T>;
+  using const_iterator = iterator;
+
+ public:
+  explicit SkipList(Compare compare = Compare(),
+                    const Allocator& allocator = Allocator())
+      : height_(1),
+        size_(0),
+        random_(0x9e3779b9u),
+        comparator_(compare),
+        allocator_(allocator) {
+    std::fill(head_, head_ + MAX_HEIGHT, nullptr);
+  }
+
+  SkipList(const SkipList& other)
+      : height_(1),
+        size_(0),
+        random_(other.random_),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    std::fill(head_, head_ + MAX_HEIGHT, nullptr);
+
+    // The values come in order, so each node goes after the last one.
+    Node* last[MAX_HEIGHT] = {};
+    try {
+      for (auto& value : other) {
+        auto node = makeNode(randomHeight(), value);
+        height_ = std::max(height_, node->height_);
+        for (std::size_t level = 0; level < node->height_; ++level) {
+          link(last[level], level) = node;
+          last[level] = node;
+        }
+        ++size_;
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  SkipList(SkipList&& other)
+      : height_(other.height_),
+        size_(other.size_),
+        random_(other.random_),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    std::copy(other.head_, other.head_ + MAX_HEIGHT, head_);
+    std::fill(other.head_, other.head_ + MAX_HEIGHT, nullptr);
+    other.height_ = 1;
+    other.size_ = 0;
+  }
+
+  SkipList& operator=(SkipList other) {
+    swap(other);
+    return *this;
+  }
+
+  ~SkipList() { clear(); }
+
+  void swap(SkipList& other) {
+    using std::swap;
+    std::swap_ranges(head_, head_ + MAX_HEIGHT, other.head_);
+    swap(height_, other.height_);
+    swap(size_, other.size_);
+    swap(random_, other.random_);
+    swap(stats_, other.stats_);
+    swap(comparator_, other.comparator_);
+    swap(allocator_, other.allocator_);
+  }
+
+  // Returns false if an equal value is in the list already.
+  bool insert(const T& value) { return insertValue(value); }
+
+  bool insert(T&& value) { return insertValue(std::move(value)); }
+
+  // Returns false if no equal value is in the list.
+  bool remove(const T& value) {
+    Node* previous[MAX_HEIGHT];
+    auto node = findPrevious(value, previous);
+    if (!node || !equal(node->value_, value)) {
+      return false;
+    }
+
+    for (std::size_t level = 0; level < node->height_; ++level) {
+      link(previous[level], level) = node->next(level);
+    }
+
+    while (height_ > 1 && !head_[height_ - 1]) {
+      --height_;
+    }
+
+    freeNode(node);
+    --size_;
+    return true;
+  }
+
+  const T* find(const T& value) const {
+    auto node = findPrevious(value, nullptr);
+    return node && equal(node->value_, value) ? &node->value_ : nullptr;
+  }
+
+  bool contains(const T& value) const { return find(value) != nullptr; }
+
+  // The first value not less than value.
+  const_iterator lowerBound(const T& value) const {
+    return const_iterator(findPrevious(value, nullptr));
+  }
+
+  // Calls callback with the values in [first, last) in order and returns how
+  // many there were.
+  template <typename Callback>
+  std::size_t scan(const T& first, const T& last, Callback&& callback) const {
+    std::size_t count = 0;
+    for (auto it = lowerBound(first); it != end() && lessThan(*it, last);
+         ++it) {
+      callback(*it);
+      ++count;
+    }
+
+    return count;
+  }
+
+  const_iterator begin() const { return const_iterator(head_[0]); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  const T* head() const { return head_[0] ? &head_[0]->value_ : nullptr; }
+
+  bool isEmpty() const { return !size_; }
+
+  std::size_t size() const { return size_; }
+
+  // Number of levels in use.
+  std::size_t height() const { return height_; }
+
+  void clear() {
+    auto node = head_[0];
+    while (node) {
+      auto next = node->next_;
+      freeNode(node);
+      node = next;
+    }
+
+    std::fill(head_, head_ + MAX_HEIGHT, nullptr);
+    height_ = 1;
+    size_ = 0;
+  }
+
+  std::vector<T> toArray() const { return std::vector<T>(begin(), end()); }
+
+  // Writes the values separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeValues(writer, [&](const T& value) { writer.write(value); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeValues(writer,
+                       [&](const T& value) { writer.write(callback(value)); });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+ public:
+  const Stats& stats() const { return stats_; }
+
+  Allocator getAllocator() const { return allocator_; }
+
+ private:
+  // next_ is the bottom level link, the links of the levels above follow the
+  // node in the same allocation.
+  struct Node {
+    template <typename... Args>
+    explicit Node(std::size_t height, Args&&... args)
+        : next_(nullptr), height_(height), value_(std::forward<Args>(args)...) {
+      std::fill(tower(), tower() + height - 1, nullptr);
+    }
+
+    Node*& next(std::size_t level) {
+      return level ? tower()[level - 1] : next_;
+    }
+
+    Node** tower() { return reinterpret_cast<Node**>(this + 1); }
+
+    Node* next_;
+    std::size_t height_;
+    T value_;
+  };
+
+  using node_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits_t = std::allocator_traits<node_allocator_t>;
+
+  // Nodes are allocated as arrays of Node sized to hold the tower too.
+  static std::size_t unitsOf(std::size_t height) {
+    return 1 + ((height - 1) * sizeof(Node*) + sizeof(Node) - 1) / sizeof(Node);
+  }
+
+  template <typename... Args>
+  Node* makeNode(std::size_t height, Args&&... args) {
+    stats_.countAllocation();
+    node_allocator_t allocator(allocator_);
+    auto units = unitsOf(height);
+    auto node = node_traits_t::allocate(allocator, units);
+
+    try {
+      ::new (static_cast<void*>(node))
+          Node(height, std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits_t::deallocate(allocator, node, units);
+      throw;
+    }
+
+    return node;
+  }
+
+  void freeNode(Node* node) {
+    node_allocator_t allocator(allocator_);
+    auto units = unitsOf(node->height_);
+    node->~Node();
+    node_traits_t::deallocate(allocator, node, units);
+  }
+
+  // The link leaving node on level, the head link if node is null.
+  Node*& link(Node* node, std::size_t level) {
+    return node ? node->next(level) : head_[level];
+  }
+
+  Node* next(Node* node, std::size_t level) const {
+    return node ? node->next(level) : head_[level];
+  }
+
+  // Returns the first node not less than value. Fills previous, if given,
+  // with the last node before it on every level in use, null for the head.
+  Node* findPrevious(const T& value, Node** previous) const {
+    Node* node = nullptr;
+
+    for (auto level = height_; level-- > 0;) {
+      for (auto nextNode = next(node, level);
+           nextNode && lessThan(nextNode->value_, value);
+           nextNode = next(node, level)) {
+        stats_.countNodeVisit();
+        node = nextNode;
+      }
+
+      if (previous) {
+        previous[level] = node;
+      }
+    }
+
+    return next(node, 0);
+  }
+
+  template <typename Value>
+  bool insertValue(Value&& value) {
+    Node* previous[MAX_HEIGHT];
+    auto nextNode = findPrevious(value, previous);
+    if (nextNode && equal(nextNode->value_, value)) {
+      return false;
+    }
+
+    auto node = makeNode(randomHeight(), std::forward<Value>(value));
+    for (; height_ < node->height_; ++height_) {
+      previous[height_] = nullptr;
+    }
+
+    for (std::size_t level = 0; level < node->height_; ++level) {
+      node->next(level) = link(previous[level], level);
+      link(previous[level], level) = node;
+    }
+
+    ++size_;
+    return true;
+  }
+
+  // One level more with probability 1/4, from a xorshift generator.
+  std::size_t randomHeight() {
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+
+    std::size_t height = 1;
+    for (auto bits = random_; height < MAX_HEIGHT && !(bits & 3); bits >>= 2) {
+      ++height;
+    }
+
+    return height;
+  }
+
+  template <typename Writer, typename WriteValue>
+  Writer& writeValues(Writer& writer, WriteValue writeValue) const {
+    bool first = true;
+    for (auto& value : *this) {
+      if (!first) {
+        writer.write(',');
+      }
+      first = false;
+
+      writeValue(value);
+    }
+
+    return writer;
+  }
+
+  bool lessThan(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.lessThan(a, b);
+  }
+
+  bool equal(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.equal(a, b);
+  }
+
+ private:
+  Node* head_[MAX_HEIGHT];
+  std::size_t height_;
+  std::size_t size_;
+  std::uint32_t random_;
+  Comparator<T, Compare> comparator_;
+  mutable Stats stats_;
+  Allocator allocator_;
+};
@@ -0,0 +1,288 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Binary snapshots of the containers.
+//
+// A snapshot starts with a fixed header followed by a container specific
+// payload. Values are stored in native byte order. Fixed size values are
+// copied as raw bytes and strings are stored as a 32 bit length followed by
+// the characters. The header records the byte order, so a snapshot taken on a
+// machine with a different byte order is rejected instead of misread.
+
+class SnapshotError : public std::runtime_error {
+ public:
+  explicit SnapshotError(const std::string& what) : std::runtime_error(what) {}
+};
+
+enum class SnapshotKind : std::uint32_t {
+  // LinkedList, Queue and Stack: the values from head to tail.
+  SEQUENCE = 1,
+  // HashTable: the entries grouped by bucket.
+  HASH_TABLE = 2,
+  // MinHeap: the items in heap order.
+  HEAP = 3,
+  // PriorityQueue: the priorities followed by a HEAP snapshot.
+  PRIORITY_QUEUE = 4,
+  // BinarySearchTree, AvlTree and RedBlackTree: the values in sorted order.
+  SORTED = 5,
+  // Trie: the nodes in pre-order.
+  TRIE = 6,
+};
+
+// Constants of the snapshot header. A template so that its static members can
+// be defined in this header.
+template <typename Unused = void>
+struct BasicSnapshotFormat {
+  static const char MAGIC[4];
+  static const std::uint32_t BYTE_ORDER_MARK;
+  static const std::uint32_t VERSION;
+};
+
+template <typename Unused>
+const char BasicSnapshotFormat<Unused>::MAGIC[4] = {'D', 'S', 'S', 'N'};
+
+template <typename Unused>
+const std::uint32_t BasicSnapshotFormat<Unused>::BYTE_ORDER_MARK = 0x01020304;
+
+template <typename Unused>
+const std::uint32_t BasicSnapshotFormat<Unused>::VERSION = 1;
+
+using SnapshotFormat = BasicSnapshotFormat<>;
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// Encodes values of type T. Specialized below for strings and pairs, the
+// primary template handles trivially copyable types.
+template <typename T, typename Enable = void>
+struct SnapshotCodec {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Snapshots support trivially copyable types, std::string and "
+                "std::pair of those");
+
+  // Size of every encoded value, or 0 when the size varies.
+  static const std::uint32_t fixed_size = sizeof(T);
+  // Lower bound of the encoded size, used to validate element counts.
+  static const std::size_t min_size = sizeof(T);
+
+  static std::size_t size(const T&) { return sizeof(T); }
+  static void write(SnapshotWriter& writer, const T& value);
+  static T read(SnapshotReader& reader);
+};
+
+template <>
+struct SnapshotCodec<bool> {
+  static const std::uint32_t fixed_size = 1;
+  static const std::size_t min_size = 1;
+
+  static std::size_t size(bool) { return 1; }
+  static void write(SnapshotWriter& writer, bool value);
+  static bool read(SnapshotReader& reader);
+};
+
+template <>
+struct SnapshotCodec<std::string> {
+  static const std::uint32_t fixed_size = 0;
+  static const std::size_t min_size = sizeof(std::uint32_t);
+
+  static std::size_t size(const std::string& value) {
+    return sizeof(std::uint32_t) + value.size();
+  }
+  static void write(SnapshotWriter& writer, const std::string& value);
+  static std::string read(SnapshotReader& reader);
+};
+
+template <typename A, typename B>
+struct SnapshotCodec<std::pair<A, B>> {
+  static const std::uint32_t fixed_size =
+      SnapshotCodec<A>::fixed_size && SnapshotCodec<B>::fixed_size
+          ? SnapshotCodec<A>::fixed_size + SnapshotCodec<B>::fixed_size
+          : 0;
+  static const std::size_t min_size =
+      SnapshotCodec<A>::min_size + SnapshotCodec<B>::min_size;
+
+  static std::size_t size(const std::pair<A, B>& value) {
+    return SnapshotCodec<A>::size(value.first) +
+           SnapshotCodec<B>::size(value.second);
+  }
+  static void write(SnapshotWriter& writer, const std::pair<A, B>& value);
+  static std::pair<A, B> read(SnapshotReader& reader);
+};
+
+// Writes a snapshot to a binary std::ostream.
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(std::ostream& stream) : stream_(stream) {}
+
+  void writeHeader(SnapshotKind kind, std::uint32_t valueSize) {
+    writeBytes(SnapshotFormat::MAGIC, sizeof(SnapshotFormat::MAGIC));
+    write(SnapshotFormat::BYTE_ORDER_MARK);
+    write(SnapshotFormat::VERSION);
+    write(static_cast<std::uint32_t>(kind));
+    write(valueSize);
+  }
+
+  template <typename T>
+  void write(const T& value) {
+    SnapshotCodec<T>::write(*this, value);
+  }
+
+  void writeBytes(const void* data, std::size_t size) {
+    stream_.write(static_cast<const char*>(data), size);
+  }
+
+  bool good() const { return stream_.good(); }
+
+ private:
+  std::ostream& stream_;
+};
+
+// Reads a snapshot from a byte range, typically a memory-mapped file. Every
+// read is bounds checked and throws SnapshotError on malformed input.
+class SnapshotReader {
+ public:
+  SnapshotReader(const char* data, std::size_t size)
+      : data_(data), size_(size), position_(0) {}
+
+  // Checks the header and fails unless it describes a snapshot of the given
+  // kind whose values have the given size.
+  void readHeader(SnapshotKind kind, std::uint32_t valueSize) {
+    if (std::memcmp(take(sizeof(SnapshotFormat::MAGIC)), SnapshotFormat::MAGIC,
+                    sizeof(SnapshotFormat::MAGIC)) != 0) {
+      throw SnapshotError("not a snapshot");
+    }
+
+    if (read<std::uint32_t>() != SnapshotFormat::BYTE_ORDER_MARK) {
+      throw SnapshotError("snapshot has a different byte order");
+    }
+
+    if (read<std::uint32_t>() != SnapshotFormat::VERSION) {
+      throw SnapshotError("unsupported snapshot version");
+    }
+
+    if (read<std::uint32_t>() != static_cast<std::uint32_t>(kind)) {
+      throw SnapshotError("snapshot holds a different kind of container");
+    }
+
+    if (read<std::uint32_t>() != valueSize) {
+      throw SnapshotError("snapshot holds values of a different type");
+    }
+  }
+
+  // Reads an element count and checks that the remaining bytes can hold that
+  // many elements of at least the given size.
+  std::uint64_t readCount(std::size_t minimumElementSize) {
+    auto count = read<std::uint64_t>();
+    if (minimumElementSize && count > remaining() / minimumElementSize) {
+      throw SnapshotError("snapshot is truncated");
+    }
+
+    return count;
+  }
+
+  template <typename T>
+  T read() {
+    return SnapshotCodec<T>::read(*this);
+  }
+
+  void readBytes(void* data, std::size_t size) {
+    std::memcpy(data, take(size), size);
+  }
+
+  // Returns a pointer to the next bytes and skips over them.
+  const char* take(std::size_t size) {
+    if (size > remaining()) {
+      throw SnapshotError("snapshot is truncated");
+    }
+
+    auto bytes = data_ + position_;
+    position_ += size;
+    return bytes;
+  }
+
+  const char* data() const { return data_; }
+  std::size_t position() const { return position_; }
+  std::size_t remaining() const { return size_ - position_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+  std::size_t position_;
+};
+
+template <typename T, typename Enable>
+void SnapshotCodec<T, Enable>::write(SnapshotWriter& writer, const T& value) {
+  writer.writeBytes(&value, sizeof(T));
+}
+
+template <typename T, typename Enable>
+T SnapshotCodec<T, Enable>::read(SnapshotReader& reader) {
+  T value;
+  reader.readBytes(&value, sizeof(T));
+  return value;
+}
+
+inline void SnapshotCodec<bool>::write(SnapshotWriter& writer, bool value) {
+  writer.write<std::uint8_t>(value ? 1 : 0);
+}
+
+inline bool SnapshotCodec<bool>::read(SnapshotReader& reader) {
+  return reader.read<std::uint8_t>() != 0;
+}
+
+inline void SnapshotCodec<std::string>::write(SnapshotWriter& writer,
+                                              const std::string& value) {
+  writer.write(static_cast<std::uint32_t>(value.size()));
+  writer.writeBytes(value.data(), value.size());
+}
+
+inline std::string SnapshotCodec<std::string>::read(SnapshotReader& reader) {
+  auto size = reader.read<std::uint32_t>();
+  return std::string(reader.take(size), size);
+}
+
+template <typename A, typename B>
+void SnapshotCodec<std::pair<A, B>>::write(SnapshotWriter& writer,
+                                           const std::pair<A, B>& value) {
+  writer.write(value.first);
+  writer.write(value.second);
+}
+
+template <typename A, typename B>
+std::pair<A, B> SnapshotCodec<std::pair<A, B>>::read(SnapshotReader& reader) {
+  // Read in two statements, the order of evaluation of arguments is
+  // unspecified.
+  auto first = reader.read<A>();
+  auto second = reader.read<B>();
+  return std::make_pair(std::move(first), std::move(second));
+}
@@ -0,0 +1,134 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "snapshot.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_HAS_MMAP 1
+#endif
+
+// Read-only view of a whole file. The file is memory-mapped where POSIX mmap
+// is available, so loading a snapshot only pages in what is actually read.
+// Elsewhere the file is read into memory.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+#ifdef SNAPSHOT_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw SnapshotError("cannot open " + path);
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+      ::close(fd);
+      throw SnapshotError("cannot stat " + path);
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_) {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        throw SnapshotError("cannot map " + path);
+      }
+      data_ = static_cast<const char*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#else
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    if (!stream) {
+      throw SnapshotError("cannot open " + path);
+    }
+
+    buffer_.assign(std::istreambuf_iterator<char>(stream),
+                   std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef SNAPSHOT_HAS_MMAP
+    if (data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Hints that the file is about to be read from start to end, as done when a
+  // container is rebuilt from it.
+  void adviseSequential() const {
+#ifdef SNAPSHOT_HAS_MMAP
+    if (data_) {
+      ::madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+    }
+#endif
+  }
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+#ifndef SNAPSHOT_HAS_MMAP
+  std::string buffer_;
+#endif
+};
+
+// Writes a snapshot of any container to a file.
+template <typename Container>
+void saveSnapshot(const Container& container, const std::string& path) {
+  std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+  SnapshotWriter writer(stream);
+  container.writeSnapshot(writer);
+
+  stream.flush();
+  if (!stream) {
+    throw SnapshotError("cannot write " + path);
+  }
+}
+
+// Replaces the content of a container with a snapshot file.
+template <typename Container>
+void loadSnapshot(const std::string& path, Container* container) {
+  MappedFile file(path);
+  file.adviseSequential();
+
+  SnapshotReader reader(file.data(), file.size());
+  container->readSnapshot(reader);
+}
@@ -0,0 +1,164 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "comparator.hpp"
+#include "hash_table.hpp"
+#include "snapshot.hpp"
+
+// Read-only views answering queries directly from the bytes of a snapshot,
+// e.g. a MappedFile, without building the container. The bytes must outlive
+// the view.
+
+// Binary search over a SORTED snapshot of a BinarySearchTree, AvlTree or
+// RedBlackTree. The values must have a fixed encoded size so that they can be
+// addressed by index.
+template <typename T, typename Compare = DefaultCompare<T>>
+class SortedSnapshotView {
+  static_assert(SnapshotCodec<T>::fixed_size != 0,
+                "SortedSnapshotView needs values of a fixed size");
+
+ public:
+  SortedSnapshotView(const char* data, std::size_t size,
+                     Compare compare = Compare())
+      : comparator_(compare) {
+    SnapshotReader reader(data, size);
+    reader.readHeader(SnapshotKind::SORTED, SnapshotCodec<T>::fixed_size);
+    size_ = reader.readCount(SnapshotCodec<T>::fixed_size);
+    values_ = reader.take(size_ * SnapshotCodec<T>::fixed_size);
+  }
+
+  std::size_t size() const { return size_; }
+
+  T at(std::size_t index) const {
+    SnapshotReader reader(values_ + index * SnapshotCodec<T>::fixed_size,
+                          SnapshotCodec<T>::fixed_size);
+    return reader.read<T>();
+  }
+
+  // Index of the first value that is not less than the given one, or size()
+  // if there is none.
+  std::size_t lowerBound(const T& value) const {
+    std::size_t first = 0;
+    std::size_t count = size_;
+
+    while (count > 0) {
+      auto step = count / 2;
+      if (comparator_.lessThan(at(first + step), value)) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+
+    return first;
+  }
+
+  bool contains(const T& value) const {
+    auto index = lowerBound(value);
+    return index < size_ && comparator_.equal(at(index), value);
+  }
+
+ private:
+  const char* values_;
+  std::size_t size_;
+  Comparator<T, Compare> comparator_;
+};
+
+// Key lookups in a HASH_TABLE snapshot of a HashTable<T, N>. Only the bucket
+// of the key is scanned, the same as in the table itself.
+template <typename T, std::size_t N = 32>
+class HashTableSnapshotView {
+ public:
+  HashTableSnapshotView(const char* data, std::size_t size) {
+    SnapshotReader reader(data, size);
+    reader.readHeader(SnapshotKind::HASH_TABLE, SnapshotCodec<T>::fixed_size);
+    if (reader.readCount(sizeof(std::uint64_t)) != N) {
+      throw SnapshotError("snapshot has a different bucket count");
+    }
+
+    offsets_ = reader.take((N + 1) * sizeof(std::uint64_t));
+    entries_ = reader.data() + reader.position();
+    entries_size_ = offset(N);
+    if (entries_size_ > reader.remaining()) {
+      throw SnapshotError("snapshot is truncated");
+    }
+  }
+
+  // Copies the value of the key to value, which may be null, and returns
+  // whether the key was found.
+  bool get(const std::string& key, T* value) const {
+    auto bucket = HashTable<T, N>::hash(key);
+    auto begin = offset(bucket);
+    auto end = offset(bucket + 1);
+    if (begin > end || end > entries_size_) {
+      throw SnapshotError("snapshot has a corrupt bucket offset");
+    }
+
+    SnapshotReader reader(entries_ + begin, end - begin);
+    while (reader.remaining()) {
+      auto length = reader.read<std::uint32_t>();
+      auto characters = reader.take(length);
+
+      if (length == key.size() &&
+          std::memcmp(characters, key.data(), length) == 0) {
+        if (value) {
+          *value = reader.read<T>();
+        }
+
+        return true;
+      }
+
+      skipValue(&reader);
+    }
+
+    return false;
+  }
+
+  bool has(const std::string& key) const { return get(key, nullptr); }
+
+ private:
+  std::uint64_t offset(std::size_t bucket) const {
+    std::uint64_t value;
+    std::memcpy(&value, offsets_ + bucket * sizeof(value), sizeof(value));
+    return value;
+  }
+
+  static void skipValue(SnapshotReader* reader) {
+    if (SnapshotCodec<T>::fixed_size) {
+      reader->take(SnapshotCodec<T>::fixed_size);
+    } else {
+      reader->read<T>();
+    }
+  }
+
+ private:
+  const char* offsets_;
+  const char* entries_;
+  std::uint64_t entries_size_;
+};
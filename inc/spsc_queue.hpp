@@ -0,0 +1,218 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Bounded lock-free queue between one producer thread and one consumer
+// thread. The ring buffer is allocated once. The producer only writes tail_
+// and the consumer only writes head_, each on its own cache line, and both
+// publish with release stores that the other side reads with acquire loads.
+// Each side keeps a copy of the other's index and rereads it only when the
+// queue looks full or empty, so a steady stream of handoffs does not bounce
+// cache lines on every operation.
+//
+// enqueue, emplace and enqueueBulk may only be called by the producer,
+// dequeue, tryDequeue, dequeueBulk and peek only by the consumer.
+template <typename T, typename Allocator = std::allocator<T>>
+class SpscQueue {
+ public:
+  static const std::size_t CACHE_LINE_SIZE = 64;
+
+ public:
+  // The capacity is rounded up to a power of two.
+  explicit SpscQueue(std::size_t capacity,
+                     const Allocator& allocator = Allocator())
+      : tail_(0),
+        cached_head_(0),
+        head_(0),
+        cached_tail_(0),
+        capacity_(roundUp(capacity)),
+        allocator_(allocator) {
+    buffer_ = traits_t::allocate(allocator_, capacity_);
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  ~SpscQueue() {
+    for (auto index = head_.load(); index != tail_.load(); ++index) {
+      slot(index).~T();
+    }
+
+    traits_t::deallocate(allocator_, buffer_, capacity_);
+  }
+
+  // Returns false if the queue is full.
+  bool enqueue(const T& value) { return emplace(value); }
+
+  bool enqueue(T&& value) { return emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (!freeSlots(tail, 1)) {
+      return false;
+    }
+
+    ::new (static_cast<void*>(&slot(tail))) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Copies as many of the count values as fit and publishes them at once.
+  // Returns how many were enqueued.
+  std::size_t enqueueBulk(const T* values, std::size_t count) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    count = freeSlots(tail, count);
+
+    // The free slots wrap around the end of the buffer at most once.
+    auto first = std::min(count, capacity_ - (tail & mask()));
+    std::uninitialized_copy(values, values + first, &slot(tail));
+    try {
+      std::uninitialized_copy(values + first, values + count, buffer_);
+    } catch (...) {
+      tail_.store(tail + first, std::memory_order_release);
+      throw;
+    }
+
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // Returns T() if the queue is empty, use tryDequeue to tell it apart.
+  T dequeue() {
+    T value = T();
+    tryDequeue(value);
+    return value;
+  }
+
+  // Moves the head into value. Returns false and leaves value alone if the
+  // queue is empty.
+  bool tryDequeue(T& value) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (!readySlots(head, 1)) {
+      return false;
+    }
+
+    auto& front = slot(head);
+    value = std::move(front);
+    front.~T();
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves up to count values into values and releases their slots at once.
+  // Returns how many were moved.
+  std::size_t dequeueBulk(T* values, std::size_t count) {
+    auto head = head_.load(std::memory_order_relaxed);
+    count = readySlots(head, count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      auto& front = slot(head + i);
+      values[i] = std::move(front);
+      front.~T();
+    }
+
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  // The head, valid until the consumer dequeues it.
+  T* peek() {
+    auto head = head_.load(std::memory_order_relaxed);
+    return readySlots(head, 1) ? &slot(head) : nullptr;
+  }
+
+  // Exact only while the other side is idle.
+  bool isEmpty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  std::size_t size() const {
+    auto head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  using traits_t = std::allocator_traits<Allocator>;
+
+  static std::size_t roundUp(std::size_t capacity) {
+    std::size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded *= 2;
+    }
+
+    return rounded;
+  }
+
+  std::size_t mask() const { return capacity_ - 1; }
+
+  // Indices grow without bound and wrap onto the buffer.
+  T& slot(std::size_t index) { return buffer_[index & mask()]; }
+
+  // Up to count slots the producer may fill after tail. Rereads the head
+  // only if the cached one leaves too few.
+  std::size_t freeSlots(std::size_t tail, std::size_t count) {
+    if (capacity_ - (tail - cached_head_) < count) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+
+    return std::min(count, capacity_ - (tail - cached_head_));
+  }
+
+  // Up to count slots the consumer may take after head. Rereads the tail
+  // only if the cached one leaves too few.
+  std::size_t readySlots(std::size_t head, std::size_t count) {
+    if (cached_tail_ - head < count) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+
+    return std::min(count, cached_tail_ - head);
+  }
+
+ private:
+  // Written by the producer.
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_;
+  std::size_t cached_head_;
+
+  // Written by the consumer.
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_;
+  std::size_t cached_tail_;
+
+  // Read by both.
+  alignas(CACHE_LINE_SIZE) T* buffer_;
+  std::size_t capacity_;
+  Allocator allocator_;
+};
+
+template <typename T, typename Allocator>
+const std::size_t SpscQueue<T, Allocator>::CACHE_LINE_SIZE;
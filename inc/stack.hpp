@@ -23,13 +23,20 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
-#include "linked_list.hpp"
+#include "doubly_linked_list.hpp"
+#include "stats.hpp"
 
-template <typename T>
+template <typename T, typename Stats = NoStats,
+          typename Allocator = std::allocator<T>>
 class Stack {
  public:
+  explicit Stack(const Allocator& allocator = Allocator())
+      : linked_list_(DefaultCompare<T>(), allocator) {}
+
   bool isEmpty() const { return !linked_list_.tail_; }
 
   const T* peek() const {
@@ -42,29 +49,62 @@ class Stack {
 
   void push(const T& value) { linked_list_.append(value); }
 
+  void push(T&& value) { linked_list_.append(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    linked_list_.emplaceAppend(std::forward<Args>(args)...);
+  }
+
   T pop() {
+    // The removed node is no longer reachable from the stack, so its value
+    // can be moved out instead of copied. The list links back, so removing
+    // the tail does not walk the stack.
     auto removedTail = linked_list_.deleteTail();
-    return removedTail ? removedTail->value_ : T();
+    return removedTail ? std::move(removedTail->value_) : T();
   }
 
-  std::vector<T> toArray() const {
-    std::vector<LinkedListNode<T>> nodes = linked_list_.toArray();
-    std::vector<T> result(nodes.size());
-
-    std::transform(nodes.begin(), nodes.end(), result.begin(),
-                   [](LinkedListNode<T>& node) { return node.value_; });
+  void clear() { linked_list_.clear(); }
 
+  std::vector<T> toArray() const {
+    std::vector<T> result(linked_list_.begin(), linked_list_.end());
     std::reverse(result.begin(), result.end());
 
     return result;
   }
 
+  void writeSnapshot(SnapshotWriter& writer) const {
+    linked_list_.writeSnapshot(writer);
+  }
+
+  void readSnapshot(SnapshotReader& reader) {
+    linked_list_.readSnapshot(reader);
+  }
+
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return linked_list_.write(writer);
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return linked_list_.write(writer, callback);
+  }
+
   std::string toString(std::function<std::string(const T&)> callback) const {
     return linked_list_.toString(callback);
   }
 
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    return linked_list_.toString(callback);
+  }
+
   std::string toString() const { return linked_list_.toString(); }
 
+  const Stats& stats() const { return linked_list_.stats(); }
+
  private:
-  LinkedList<T> linked_list_;
+  DoublyLinkedList<T, DefaultCompare<T>, Stats, Allocator> linked_list_;
 };
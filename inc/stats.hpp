@@ -0,0 +1,114 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+// Statistics policy that records nothing. Every hook is an empty inline
+// function, so containers using it carry no counting code at all.
+struct NoStats {
+  static const bool enabled = false;
+
+  void countComparison() {}
+  void countNodeVisit() {}
+  void countRotation() {}
+  void countAllocation() {}
+};
+
+// Statistics policy that counts the operations a container performs. Work done
+// only to feed the counters is guarded by `Stats::enabled`.
+struct OperationStats {
+  static const bool enabled = true;
+
+  OperationStats()
+      : comparisons_(0), node_visits_(0), rotations_(0), allocations_(0) {}
+
+  void countComparison() { ++comparisons_; }
+  void countNodeVisit() { ++node_visits_; }
+  void countRotation() { ++rotations_; }
+  void countAllocation() { ++allocations_; }
+
+  void reset() { *this = OperationStats(); }
+
+  std::size_t comparisons_;
+  std::size_t node_visits_;
+  std::size_t rotations_;
+  std::size_t allocations_;
+};
+
+// Lets the nodes of a container report into the statistics of the container
+// that owns them. Holds nothing when statistics are disabled.
+template <typename Stats>
+class StatsHandle {
+ public:
+  explicit StatsHandle(Stats* stats = nullptr) : stats_(stats) {}
+
+  Stats* get() const { return stats_; }
+
+  void countComparison() const {
+    if (stats_) stats_->countComparison();
+  }
+
+  void countNodeVisit() const {
+    if (stats_) stats_->countNodeVisit();
+  }
+
+  void countAllocation() const {
+    if (stats_) stats_->countAllocation();
+  }
+
+ private:
+  Stats* stats_;
+};
+
+template <>
+class StatsHandle<NoStats> {
+ public:
+  explicit StatsHandle(NoStats* = nullptr) {}
+
+  NoStats* get() const { return nullptr; }
+
+  void countComparison() const {}
+  void countNodeVisit() const {}
+  void countAllocation() const {}
+};
+
+// Statistics of a container that counts from const methods. Stateful
+// policies are a mutable member, empty ones such as NoStats an empty base
+// that takes no space in the container.
+template <typename Stats, bool = std::is_empty<Stats>::value>
+class MutableStats {
+ public:
+  Stats& mutableStats() const { return stats_; }
+
+ private:
+  mutable Stats stats_;
+};
+
+template <typename Stats>
+class MutableStats<Stats, true> : private Stats {
+ public:
+  // An empty policy has no state for the hooks to change.
+  Stats& mutableStats() const { return const_cast<MutableStats&>(*this); }
+};
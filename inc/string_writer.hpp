@@ -0,0 +1,189 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+// Appends the text form of values to a single growing buffer. Containers write
+// all their elements into one writer, so serializing a container is linear in
+// its size instead of copying the partial result for every element.
+class StringWriter {
+ public:
+  explicit StringWriter(std::size_t capacity = 0) { buffer_.reserve(capacity); }
+
+  StringWriter& reserve(std::size_t capacity) {
+    buffer_.reserve(capacity);
+    return *this;
+  }
+
+  StringWriter& write(const std::string& value) {
+    buffer_.append(value);
+    return *this;
+  }
+
+  StringWriter& write(const char* value) {
+    buffer_.append(value);
+    return *this;
+  }
+
+  StringWriter& write(char value) {
+    buffer_.push_back(value);
+    return *this;
+  }
+
+  StringWriter& write(signed char value) {
+    return write(static_cast<char>(value));
+  }
+
+  StringWriter& write(unsigned char value) {
+    return write(static_cast<char>(value));
+  }
+
+  // Booleans are written as 1 and 0, the same as std::ostream does by default.
+  StringWriter& write(bool value) { return write(value ? '1' : '0'); }
+
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value, StringWriter&>::type
+  write(T value) {
+    char digits[MAX_DIGITS];
+    buffer_.append(digits, formatInteger(digits, value));
+    return *this;
+  }
+
+  // Floating point values use the default std::ostream format, "%g" with six
+  // significant digits.
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, StringWriter&>::type
+  write(T value) {
+    char digits[MAX_DIGITS];
+    buffer_.append(digits, formatFloatingPoint(digits, value));
+    return *this;
+  }
+
+  // Anything else goes through its operator<<. The stream is reused between
+  // calls, so only its buffer is reset.
+  template <typename T>
+  typename std::enable_if<!std::is_arithmetic<T>::value &&
+                              !std::is_convertible<T, const char*>::value,
+                          StringWriter&>::type
+  write(const T& value) {
+    stream_.str(std::string());
+    stream_.clear();
+    stream_ << value;
+    return write(stream_.str());
+  }
+
+  const std::string& str() const { return buffer_; }
+
+  // Hands the buffer over to the caller and leaves the writer empty.
+  std::string release() {
+    std::string result;
+    result.swap(buffer_);
+    return result;
+  }
+
+ private:
+  // Enough for a 128 bit integer or a "%g" formatted long double.
+  static const std::size_t MAX_DIGITS = 64;
+
+#if __cplusplus >= 201703L
+  template <typename T>
+  static std::size_t formatInteger(char* digits, T value) {
+    return std::to_chars(digits, digits + MAX_DIGITS, value).ptr - digits;
+  }
+
+  template <typename T>
+  static std::size_t formatFloatingPoint(char* digits, T value) {
+    return std::to_chars(digits, digits + MAX_DIGITS, value,
+                         std::chars_format::general, 6)
+               .ptr -
+           digits;
+  }
+#else
+  template <typename T>
+  static std::size_t formatInteger(char* digits, T value) {
+    using unsigned_t = typename std::make_unsigned<T>::type;
+
+    // Negate in the unsigned type so that the minimum value does not overflow.
+    bool negative = value < 0;
+    unsigned_t magnitude = static_cast<unsigned_t>(value);
+    if (negative) {
+      magnitude = 0 - magnitude;
+    }
+
+    // Fill the digits from the end and move them to the front afterwards.
+    char* end = digits + MAX_DIGITS;
+    char* begin = end;
+    do {
+      *--begin = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude);
+
+    if (negative) {
+      *--begin = '-';
+    }
+
+    std::size_t length = end - begin;
+    std::char_traits<char>::move(digits, begin, length);
+    return length;
+  }
+
+  static std::size_t formatFloatingPoint(char* digits, double value) {
+    return std::snprintf(digits, MAX_DIGITS, "%g", value);
+  }
+
+  static std::size_t formatFloatingPoint(char* digits, long double value) {
+    return std::snprintf(digits, MAX_DIGITS, "%Lg", value);
+  }
+#endif
+
+ private:
+  std::string buffer_;
+  std::ostringstream stream_;
+};
+
+// Writer with the same interface as StringWriter that forwards everything to
+// an std::ostream, e.g. to dump a large container straight into a file.
+class StreamWriter {
+ public:
+  explicit StreamWriter(std::ostream& stream) : stream_(stream) {}
+
+  template <typename T>
+  StreamWriter& write(const T& value) {
+    stream_ << value;
+    return *this;
+  }
+
+  std::ostream& stream() const { return stream_; }
+
+ private:
+  std::ostream& stream_;
+};
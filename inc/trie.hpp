@@ -24,19 +24,26 @@
 
 #include <string>
 #include <unordered_set>
+#include "snapshot.hpp"
+#include "stats.hpp"
 #include "trie_node.hpp"
 
-class Trie {
+template <typename Stats = NoStats>
+class BasicTrie {
  public:
   static const char HEAD_CHARACTER = '*';
 
-  Trie() : head_(HEAD_CHARACTER) {}
+  BasicTrie() : head_(HEAD_CHARACTER) {}
 
   void addWord(const std::string& word) {
     auto characters = word.c_str();
     TrieNode* currentNode = &head_;
     for (int charIndex = 0; charIndex < word.length(); ++charIndex) {
       auto isComplete = (charIndex == word.length() - 1);
+      stats_.countNodeVisit();
+      if (Stats::enabled && !currentNode->hasChild(characters[charIndex])) {
+        stats_.countAllocation();
+      }
       currentNode = currentNode->addChild(characters[charIndex], isComplete);
     }
   }
@@ -56,15 +63,30 @@ class Trie {
     return !!getLastCharacterNode(word);
   }
 
+  // Writes the nodes in pre-order as a TRIE snapshot.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::TRIE, 0);
+    head_.writeSnapshot(writer);
+  }
+
+  // Replaces the content of the trie with the nodes of a TRIE snapshot.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::TRIE, 0);
+    head_.readSnapshot(reader);
+  }
+
+  const Stats& stats() const { return stats_; }
+
  private:
   const TrieNode* getLastCharacterNode(const std::string& word) const {
     auto characters = word.c_str();
     const TrieNode* currentNode = &head_;
     for (int charIndex = 0; charIndex < word.length(); ++charIndex) {
-      if (!currentNode->hasChild(characters[charIndex])) {
+      stats_.countNodeVisit();
+      currentNode = currentNode->getChild(characters[charIndex]);
+      if (!currentNode) {
         return nullptr;
       }
-      currentNode = currentNode->getChild(characters[charIndex]);
     }
 
     return currentNode;
@@ -72,4 +94,9 @@ class Trie {
 
  public:
   TrieNode head_;
+
+ private:
+  mutable Stats stats_;
 };
+
+using Trie = BasicTrie<>;
@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 #include "hash_table.hpp"
+#include "snapshot.hpp"
+#include "string_writer.hpp"
 
 class TrieNode {
  public:
@@ -32,35 +35,78 @@ class TrieNode {
       : character_(character), is_complete_word_(is_complete_word) {}
 
   TrieNode* getChild(char character) const {
-    return children_.get({character});
+    return children_.get(&character, 1);
   }
 
   TrieNode* addChild(char character, bool is_complete_word = false) {
-    if (!children_.has({character})) {
-      children_.set({character}, TrieNode(character, is_complete_word));
+    auto child = getChild(character);
+    if (child) {
+      return child;
     }
 
-    return children_.get({character});
+    children_.set({character}, TrieNode(character, is_complete_word));
+    return getChild(character);
   }
 
-  bool hasChild(char character) const { return children_.has({character}); }
+  bool hasChild(char character) const { return children_.has(&character, 1); }
 
   std::unordered_set<std::string> suggestChildren() const {
     return children_.getKeys();
   }
 
+  // Writes the character, a "*" for a complete word and the children after a
+  // colon into a StringWriter or a StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    writer.write(character_);
+
+    if (is_complete_word_) {
+      writer.write('*');
+    }
+
+    auto separator = ':';
+    for (auto& child : suggestChildren()) {
+      writer.write(separator).write(child);
+      separator = ',';
+    }
+
+    return writer;
+  }
+
   std::string toString() const {
-    auto children = suggestChildren();
-    auto childrenAsString = std::accumulate(
-        children.begin(), children.end(), std::string(),
-        [](const std::string& a, const std::string& b) { return a + "," + b; });
+    StringWriter writer;
+    return write(writer).release();
+  }
 
-    childrenAsString = childrenAsString.size()
-                           ? std::string(":") + childrenAsString.substr(1)
-                           : "";
-    auto isCompleteString = is_complete_word_ ? "*" : "";
+  // Writes the node and its descendants in pre-order: the character, the
+  // complete word flag and the number of children, followed by the children.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.write(character_);
+    writer.write(is_complete_word_);
+
+    std::uint32_t childCount = 0;
+    for (auto& bucket : children_.buckets_) {
+      for (auto node = bucket.head_.get(); node; node = node->next_.get()) {
+        ++childCount;
+      }
+    }
 
-    return std::string({character_}) + isCompleteString + childrenAsString;
+    writer.write(childCount);
+    for (auto& bucket : children_.buckets_) {
+      for (auto node = bucket.head_.get(); node; node = node->next_.get()) {
+        node->value_.second.writeSnapshot(writer);
+      }
+    }
+  }
+
+  // Replaces the node and its descendants with the ones written by
+  // writeSnapshot.
+  void readSnapshot(SnapshotReader& reader) {
+    character_ = reader.read<char>();
+    is_complete_word_ = reader.read<bool>();
+
+    children_ = HashTable<TrieNode>();
+    readSnapshotChildren(reader);
   }
 
  public:
@@ -75,6 +121,21 @@ class TrieNode {
   char character_;
   bool is_complete_word_;
 
+ private:
+  void readSnapshotChildren(SnapshotReader& reader) {
+    // Every child takes at least its character, flag and child count.
+    auto childCount = reader.read<std::uint32_t>();
+    if (childCount > reader.remaining() / (2 + sizeof(std::uint32_t))) {
+      throw SnapshotError("snapshot is truncated");
+    }
+
+    for (std::uint32_t index = 0; index < childCount; ++index) {
+      auto character = reader.read<char>();
+      auto isCompleteWord = reader.read<bool>();
+      addChild(character, isCompleteWord)->readSnapshotChildren(reader);
+    }
+  }
+
  private:
   HashTable<TrieNode> children_;
 };
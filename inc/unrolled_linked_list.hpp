@@ -0,0 +1,479 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "comparator.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "string_writer.hpp"
+
+// Linked list whose nodes hold up to K values inline. Scans walk contiguous
+// arrays and chase one pointer per K values instead of one per value, and a
+// node is allocated once per K values. Values move when they are removed,
+// so find returns pointers that stay valid only until the next removal.
+template <typename T, std::size_t K = 16, typename Compare = DefaultCompare<T>,
+          typename Stats = NoStats, typename Allocator = std::allocator<T>>
+class UnrolledLinkedList {
+  static_assert(K > 0, "nodes must hold at least one value");
+
+ public:
+  explicit UnrolledLinkedList(Compare compare = Compare(),
+                              const Allocator& allocator = Allocator())
+      : head_(nullptr),
+        tail_(nullptr),
+        size_(0),
+        comparator_(compare),
+        allocator_(allocator) {}
+
+  UnrolledLinkedList(const UnrolledLinkedList& other)
+      : head_(nullptr),
+        tail_(nullptr),
+        size_(0),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    try {
+      for (auto node = other.head_; node; node = node->next_) {
+        for (auto index = node->first_; index < node->last_; ++index) {
+          append(node->values()[index]);
+        }
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  UnrolledLinkedList(UnrolledLinkedList&& other)
+      : head_(other.head_),
+        tail_(other.tail_),
+        size_(other.size_),
+        comparator_(other.comparator_),
+        allocator_(other.allocator_) {
+    other.head_ = other.tail_ = nullptr;
+    other.size_ = 0;
+  }
+
+  UnrolledLinkedList& operator=(UnrolledLinkedList other) {
+    swap(other);
+    return *this;
+  }
+
+  ~UnrolledLinkedList() { clear(); }
+
+  void swap(UnrolledLinkedList& other) {
+    using std::swap;
+    swap(head_, other.head_);
+    swap(tail_, other.tail_);
+    swap(size_, other.size_);
+    swap(stats_, other.stats_);
+    swap(comparator_, other.comparator_);
+    swap(allocator_, other.allocator_);
+  }
+
+  UnrolledLinkedList& prepend(const T& value) { return emplacePrepend(value); }
+
+  UnrolledLinkedList& prepend(T&& value) {
+    return emplacePrepend(std::move(value));
+  }
+
+  UnrolledLinkedList& append(const T& value) { return emplaceAppend(value); }
+
+  UnrolledLinkedList& append(T&& value) {
+    return emplaceAppend(std::move(value));
+  }
+
+  template <typename... Args>
+  UnrolledLinkedList& emplacePrepend(Args&&... args) {
+    if (head_ && head_->first_ > 0) {
+      head_->construct(head_->first_ - 1, std::forward<Args>(args)...);
+      --head_->first_;
+    } else {
+      // Values are prepended from the end of a new head.
+      auto node = makeNode(K - 1, std::forward<Args>(args)...);
+      node->next_ = head_;
+      head_ = node;
+
+      if (!tail_) {
+        tail_ = node;
+      }
+    }
+
+    ++size_;
+    return *this;
+  }
+
+  template <typename... Args>
+  UnrolledLinkedList& emplaceAppend(Args&&... args) {
+    if (tail_ && tail_->last_ < K) {
+      tail_->construct(tail_->last_, std::forward<Args>(args)...);
+      ++tail_->last_;
+    } else {
+      auto node = makeNode(0, std::forward<Args>(args)...);
+
+      if (tail_) {
+        tail_->next_ = node;
+      } else {
+        head_ = node;
+      }
+
+      tail_ = node;
+    }
+
+    ++size_;
+    return *this;
+  }
+
+  // Removes every value equal to the given one and returns how many were
+  // removed. The remaining values of a node are shifted down, nodes left
+  // empty are freed and a node whose values fit into the node before it is
+  // merged into that one. Any two neighbours hold more than K values
+  // afterwards, so scans stay dense however many values were removed.
+  std::size_t remove(const T& value) {
+    // The value may be one of the list's own, which is destroyed or moved
+    // during the scan, so the scan compares against a copy.
+    const T removedValue(value);
+    std::size_t removed = 0;
+    Node* previousNode = nullptr;
+    auto node = head_;
+
+    while (node) {
+      auto values = node->values();
+      auto last = node->first_;
+
+      for (auto index = node->first_; index < node->last_; ++index) {
+        if (equal(values[index], removedValue)) {
+          values[index].~T();
+          ++removed;
+        } else {
+          if (index != last) {
+            node->construct(last, std::move(values[index]));
+            values[index].~T();
+          }
+          ++last;
+        }
+      }
+      node->last_ = last;
+
+      auto nextNode = node->next_;
+      if (node->first_ == node->last_) {
+        unlink(previousNode, node);
+      } else if (previousNode && previousNode->size() + node->size() <= K) {
+        merge(previousNode, node);
+      } else {
+        previousNode = node;
+      }
+      node = nextNode;
+    }
+
+    size_ -= removed;
+    return removed;
+  }
+
+  const T* find(const T& value) const {
+    return find([&](const T& test) { return equal(test, value); });
+  }
+
+  const T* find(std::function<bool(const T&)> callback) const {
+    if (!callback) {
+      return nullptr;
+    }
+
+    return findValue(callback);
+  }
+
+  // Same as above but keeps the type of the callback so that it can be
+  // inlined instead of being called through std::function.
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  const T* find(Callback&& callback) const {
+    return findValue(callback);
+  }
+
+  // Removes the first value, moving it into value when given. Returns false
+  // if the list is empty.
+  bool deleteHead(T* value = nullptr) {
+    if (!head_) {
+      return false;
+    }
+
+    auto& head = head_->values()[head_->first_];
+    if (value) {
+      *value = std::move(head);
+    }
+    head.~T();
+    ++head_->first_;
+    --size_;
+
+    if (head_->first_ == head_->last_) {
+      unlink(nullptr, head_);
+    }
+
+    return true;
+  }
+
+  const T* head() const {
+    return head_ ? &head_->values()[head_->first_] : nullptr;
+  }
+
+  const T* tail() const {
+    return tail_ ? &tail_->values()[tail_->last_ - 1] : nullptr;
+  }
+
+  bool isEmpty() const { return !size_; }
+
+  std::size_t size() const { return size_; }
+
+  void clear() {
+    while (head_) {
+      auto node = head_;
+      head_ = node->next_;
+      freeNode(node);
+    }
+
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+  std::vector<T> toArray() const {
+    std::vector<T> result;
+    result.reserve(size_);
+
+    for (auto node = head_; node; node = node->next_) {
+      for (auto index = node->first_; index < node->last_; ++index) {
+        result.push_back(node->values()[index]);
+      }
+    }
+
+    return result;
+  }
+
+  // Writes the values separated by commas into a StringWriter or a
+  // StreamWriter.
+  template <typename Writer>
+  Writer& write(Writer& writer) const {
+    return writeValues(writer, [&](const T& value) { writer.write(value); });
+  }
+
+  template <typename Writer, typename Callback>
+  Writer& write(Writer& writer, Callback&& callback) const {
+    return writeValues(writer,
+                       [&](const T& value) { writer.write(callback(value)); });
+  }
+
+  std::string toString(std::function<std::string(const T&)> callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  template <typename Callback, typename = decltype(std::declval<Callback&>()(
+                                   std::declval<const T&>()))>
+  std::string toString(Callback&& callback) const {
+    StringWriter writer;
+    return write(writer, callback).release();
+  }
+
+  std::string toString() const {
+    StringWriter writer;
+    return write(writer).release();
+  }
+
+  // Writes the values from head to tail as a SEQUENCE snapshot, the same
+  // format as LinkedList.
+  void writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    writer.write(static_cast<std::uint64_t>(size_));
+    for (auto node = head_; node; node = node->next_) {
+      for (auto index = node->first_; index < node->last_; ++index) {
+        writer.write(node->values()[index]);
+      }
+    }
+  }
+
+  // Replaces the content of the list with the values of a SEQUENCE snapshot.
+  void readSnapshot(SnapshotReader& reader) {
+    reader.readHeader(SnapshotKind::SEQUENCE, SnapshotCodec<T>::fixed_size);
+    auto count = reader.readCount(SnapshotCodec<T>::min_size);
+
+    clear();
+    for (std::uint64_t index = 0; index < count; ++index) {
+      emplaceAppend(reader.read<T>());
+    }
+  }
+
+ public:
+  const Stats& stats() const { return stats_; }
+
+  Allocator getAllocator() const { return allocator_; }
+
+ private:
+  // Holds the values in [first_, last_) of its inline storage.
+  struct Node {
+    Node() : next_(nullptr), first_(0), last_(0) {}
+
+    T* values() { return reinterpret_cast<T*>(storage_); }
+
+    std::size_t size() const { return last_ - first_; }
+
+    const T* values() const { return reinterpret_cast<const T*>(storage_); }
+
+    template <typename... Args>
+    void construct(std::size_t index, Args&&... args) {
+      ::new (static_cast<void*>(values() + index))
+          T(std::forward<Args>(args)...);
+    }
+
+    Node* next_;
+    std::size_t first_;
+    std::size_t last_;
+    alignas(T) unsigned char storage_[K * sizeof(T)];
+  };
+
+  using node_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits_t = std::allocator_traits<node_allocator_t>;
+
+  // Allocates a node holding one value constructed at index.
+  template <typename... Args>
+  Node* makeNode(std::size_t index, Args&&... args) {
+    stats_.countAllocation();
+    node_allocator_t allocator(allocator_);
+    auto node = node_traits_t::allocate(allocator, 1);
+    ::new (static_cast<void*>(node)) Node();
+
+    try {
+      node->construct(index, std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits_t::deallocate(allocator, node, 1);
+      throw;
+    }
+
+    node->first_ = index;
+    node->last_ = index + 1;
+    return node;
+  }
+
+  void freeNode(Node* node) {
+    for (auto index = node->first_; index < node->last_; ++index) {
+      node->values()[index].~T();
+    }
+
+    node_allocator_t allocator(allocator_);
+    node->~Node();
+    node_traits_t::deallocate(allocator, node, 1);
+  }
+
+  // Frees an empty node given the node before it.
+  void unlink(Node* previousNode, Node* node) {
+    if (previousNode) {
+      previousNode->next_ = node->next_;
+    } else {
+      head_ = node->next_;
+    }
+
+    if (tail_ == node) {
+      tail_ = previousNode;
+    }
+
+    freeNode(node);
+  }
+
+  // Moves the values of node behind those of previousNode, which holds room
+  // for them once its own values are shifted to the front, and frees node.
+  void merge(Node* previousNode, Node* node) {
+    if (previousNode->last_ + node->size() > K) {
+      auto values = previousNode->values();
+      auto first = previousNode->first_;
+      for (auto index = first; index < previousNode->last_; ++index) {
+        previousNode->construct(index - first, std::move(values[index]));
+        values[index].~T();
+      }
+      previousNode->first_ = 0;
+      previousNode->last_ -= first;
+    }
+
+    auto values = node->values();
+    for (auto index = node->first_; index < node->last_; ++index) {
+      previousNode->construct(previousNode->last_, std::move(values[index]));
+      values[index].~T();
+      ++previousNode->last_;
+    }
+    node->last_ = node->first_;
+
+    unlink(previousNode, node);
+  }
+
+  template <typename Writer, typename WriteValue>
+  Writer& writeValues(Writer& writer, WriteValue writeValue) const {
+    bool first = true;
+    for (auto node = head_; node; node = node->next_) {
+      for (auto index = node->first_; index < node->last_; ++index) {
+        if (!first) {
+          writer.write(',');
+        }
+        first = false;
+
+        writeValue(node->values()[index]);
+      }
+    }
+
+    return writer;
+  }
+
+  template <typename Callback>
+  const T* findValue(Callback& callback) const {
+    for (auto node = head_; node; node = node->next_) {
+      stats_.countNodeVisit();
+
+      auto first = node->values() + node->first_;
+      auto last = node->values() + node->last_;
+      auto found = std::find_if(first, last, std::ref(callback));
+      if (found != last) {
+        return found;
+      }
+    }
+
+    return nullptr;
+  }
+
+  bool equal(const T& a, const T& b) const {
+    stats_.countComparison();
+    return comparator_.equal(a, b);
+  }
+
+ private:
+  Node* head_;
+  Node* tail_;
+  std::size_t size_;
+  Comparator<T, Compare> comparator_;
+  mutable Stats stats_;
+  Allocator allocator_;
+};
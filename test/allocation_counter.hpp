@@ -0,0 +1,58 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include "gtest/gtest.h"
+
+// Number of heap allocations made so far by the calling thread. Counted by
+// the replacement operator new in allocation_counter.cc, which is linked into
+// the test binary.
+std::size_t allocationCount();
+
+// Counts the heap allocations the calling thread makes while it is alive.
+class AllocationScope {
+ public:
+  AllocationScope() : start_(allocationCount()) {}
+
+  std::size_t allocations() const { return allocationCount() - start_; }
+
+ private:
+  std::size_t start_;
+};
+
+// Expects the statement to make exactly `count` heap allocations on the
+// calling thread. Only the statement is measured, not the assertion.
+#define EXPECT_ALLOCS(count, statement)                               \
+  do {                                                                \
+    std::size_t expect_allocs_count;                                  \
+    {                                                                 \
+      AllocationScope expect_allocs_scope;                            \
+      statement;                                                      \
+      expect_allocs_count = expect_allocs_scope.allocations();        \
+    }                                                                 \
+    EXPECT_EQ(static_cast<std::size_t>(count), expect_allocs_count)   \
+        << "allocations made by: " #statement;                        \
+  } while (0)
+
+#define EXPECT_NO_ALLOC(statement) EXPECT_ALLOCS(0, statement)
@@ -0,0 +1,48 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "test/allocation_counter.hpp"
+#include "gtest/gtest.h"
+
+TEST(AllocationCounterTest, count_allocations) {
+  std::unique_ptr<int> pointer;
+  EXPECT_ALLOCS(1, pointer.reset(new int(1)));
+
+  std::vector<int> values;
+  EXPECT_ALLOCS(1, values.reserve(16));
+  EXPECT_NO_ALLOC(values.push_back(1));
+
+  std::string text;
+  EXPECT_ALLOCS(1, text.assign(64, 'x'));
+  EXPECT_NO_ALLOC(text.clear());
+}
+
+TEST(AllocationCounterTest, scope) {
+  AllocationScope scope;
+
+  auto values = std::make_shared<std::vector<int>>(8);
+
+  EXPECT_EQ(scope.allocations(), 2);
+}
@@ -0,0 +1,196 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "async_queue.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+
+// Coroutine that starts right away and frees itself when it finishes.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return DetachedTask(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+DetachedTask consume(AsyncQueue<int>& queue, int count,
+                     std::vector<int>* received) {
+  for (int i = 0; i < count; ++i) {
+    received->push_back(co_await queue.dequeue());
+  }
+}
+
+DetachedTask sum(AsyncQueue<int>& queue, long long* total) {
+  *total += co_await queue.dequeue();
+}
+
+DetachedTask receive(AsyncQueue<std::unique_ptr<std::string>>& queue,
+                     std::string* received) {
+  std::unique_ptr<std::string> value = co_await queue.dequeue();
+  *received = *value;
+}
+
+// Has no default constructor.
+struct Ticket {
+  explicit Ticket(int number) : number_(number) {}
+
+  int number_;
+};
+
+DetachedTask redeem(AsyncQueue<Ticket>& queue, int* number) {
+  *number = (co_await queue.dequeue()).number_;
+}
+
+}  // namespace
+
+TEST(AsyncQueueTest, take_ready_values_without_suspending) {
+  EventLoop loop;
+  AsyncQueue<int> queue(loop);
+  std::vector<int> received;
+
+  queue.enqueue(1);
+  queue.enqueue(2);
+  consume(queue, 2, &received);
+
+  EXPECT_EQ(received, std::vector<int>({1, 2}));
+  EXPECT_EQ(loop.run(), 0u);
+}
+
+TEST(AsyncQueueTest, resume_on_enqueue_through_executor) {
+  EventLoop loop;
+  AsyncQueue<int> queue(loop);
+  std::vector<int> received;
+
+  consume(queue, 3, &received);
+  EXPECT_EQ(queue.waiting(), 1u);
+
+  queue.enqueue(1);
+  queue.enqueue(2);
+  // Resumed by the loop, not by enqueue.
+  EXPECT_TRUE(received.empty());
+  EXPECT_EQ(queue.size(), 1u);
+
+  EXPECT_EQ(loop.run(), 1u);
+  EXPECT_EQ(received, std::vector<int>({1, 2}));
+  EXPECT_EQ(queue.waiting(), 1u);
+
+  queue.enqueue(3);
+  loop.run();
+  EXPECT_EQ(received, std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(queue.waiting(), 0u);
+}
+
+TEST(AsyncQueueTest, move_only_values) {
+  EventLoop loop;
+  AsyncQueue<std::unique_ptr<std::string>> queue(loop);
+  std::string received;
+
+  receive(queue, &received);
+
+  queue.emplace(new std::string("a"));
+  loop.run();
+  EXPECT_EQ(received, "a");
+}
+
+TEST(AsyncQueueTest, values_without_default_constructor) {
+  EventLoop loop;
+  AsyncQueue<Ticket> queue(loop);
+  int first = 0;
+  int second = 0;
+
+  queue.emplace(1);
+  redeem(queue, &first);
+  EXPECT_EQ(first, 1);
+
+  redeem(queue, &second);
+  queue.emplace(2);
+  loop.run();
+  EXPECT_EQ(second, 2);
+}
+
+TEST(AsyncQueueTest, steady_state_handoff_does_not_allocate) {
+  EventLoop loop;
+  AsyncQueue<int> queue(loop);
+  std::vector<int> received;
+  received.reserve(2000);
+
+  consume(queue, 2000, &received);
+  for (int i = 0; i < 1000; ++i) {
+    queue.enqueue(i);
+    loop.run();
+  }
+
+  EXPECT_NO_ALLOC(for (int i = 1000; i < 2000; ++i) {
+    queue.enqueue(i);
+    loop.run();
+  });
+  EXPECT_EQ(received.size(), 2000u);
+  EXPECT_EQ(received.back(), 1999);
+}
+
+TEST(AsyncQueueTest, many_consumers) {
+  const int consumerCount = 10000;
+  EventLoop loop;
+  AsyncQueue<int> queue(loop);
+  long long total = 0;
+
+  for (int i = 0; i < consumerCount; ++i) sum(queue, &total);
+  EXPECT_EQ(queue.waiting(), static_cast<std::size_t>(consumerCount));
+
+  for (int i = 0; i < consumerCount; ++i) queue.enqueue(i);
+  EXPECT_EQ(loop.run(), static_cast<std::size_t>(consumerCount));
+  EXPECT_EQ(total, 1LL * consumerCount * (consumerCount - 1) / 2);
+  EXPECT_EQ(queue.waiting(), 0u);
+}
+
+TEST(AsyncQueueTest, producer_threads) {
+  const int perThread = 1000;
+  EventLoop loop;
+  AsyncQueue<int> queue(loop);
+  long long total = 0;
+
+  for (int i = 0; i < 4 * perThread; ++i) sum(queue, &total);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 4; ++t) {
+    producers.emplace_back([&, t]() {
+      for (int i = 0; i < perThread; ++i) queue.enqueue(t * perThread + i);
+    });
+  }
+  for (auto& producer : producers) producer.join();
+
+  loop.run();
+  EXPECT_EQ(total, 4LL * perThread * (4 * perThread - 1) / 2);
+}
+
+#endif  // defined(__cpp_impl_coroutine)
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "avl_tree.hpp"
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(AvlTreeNodeTest, simple_left_left) {
@@ -259,3 +260,14 @@ TEST(AvlTreeNodeTest, remove) {
 
   EXPECT_THROW(tree.remove(1), AvlTree<int>::MethodNotImplementedException);
 }
+
+TEST(AvlTreeNodeTest, contains_does_not_allocate) {
+  AvlTree<int> tree;
+
+  for (int value = 0; value < 32; ++value) {
+    tree.insert(value);
+  }
+
+  EXPECT_NO_ALLOC(EXPECT_TRUE(tree.contains(17)));
+  EXPECT_NO_ALLOC(EXPECT_FALSE(tree.contains(32)));
+}
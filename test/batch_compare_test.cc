@@ -0,0 +1,120 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "comparator.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+// Checks compareMany and minIndex against one scalar compare per element for
+// every span length, so that both the vectorized part and the tail are hit.
+template <typename T>
+void expectMatchesScalar(const std::vector<T>& values, T key) {
+  Comparator<T> comparator;
+
+  for (std::size_t count = 0; count <= values.size(); ++count) {
+    std::vector<int> results(count, 42);
+    comparator.compareMany(key, values.data(), count, results.data());
+
+    for (std::size_t index = 0; index < count; ++index) {
+      EXPECT_EQ(results[index], comparator.compare(values[index], key))
+          << "count " << count << " index " << index;
+    }
+
+    if (!count) continue;
+
+    std::size_t best = 0;
+    for (std::size_t index = 1; index < count; ++index) {
+      if (comparator.lessThan(values[index], values[best])) best = index;
+    }
+    EXPECT_EQ(comparator.minIndex(values.data(), count), best)
+        << "count " << count;
+  }
+}
+
+template <typename T>
+std::vector<T> randomValues(std::size_t size, int range) {
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<int> distribution(-range, range);
+
+  std::vector<T> values;
+  for (std::size_t index = 0; index < size; ++index) {
+    values.push_back(static_cast<T>(distribution(generator)));
+  }
+
+  return values;
+}
+
+}  // namespace
+
+TEST(BatchCompareTest, int_values) {
+  auto values = randomValues<int>(40, 10);
+  expectMatchesScalar(values, 0);
+  expectMatchesScalar(values, 3);
+
+  std::vector<int> extremes = {std::numeric_limits<int>::max(), 0, -1,
+                               std::numeric_limits<int>::min(), 7, 7, 7, 7,
+                               std::numeric_limits<int>::min()};
+  expectMatchesScalar(extremes, std::numeric_limits<int>::min());
+  expectMatchesScalar(extremes, std::numeric_limits<int>::max());
+}
+
+TEST(BatchCompareTest, floating_point_values) {
+  expectMatchesScalar(randomValues<float>(40, 10), 2.0f);
+  expectMatchesScalar(randomValues<double>(40, 10), -2.0);
+
+  // Both zeros are equal, so the first of them is the minimum.
+  std::vector<double> zeros = {1.0, 0.0, 2.0, -0.0, 0.0, 3.0, -0.0, 4.0};
+  expectMatchesScalar(zeros, 0.0);
+  Comparator<double> comparator;
+  EXPECT_EQ(comparator.minIndex(zeros.data(), zeros.size()), 1);
+}
+
+TEST(BatchCompareTest, nan_values) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  // A NaN is never less than anything, and nothing is less than a NaN.
+  std::vector<float> leadingNan = {nan, -1, -2, -3, -4, -5, -6, -7, -8, -9};
+  std::vector<float> innerNan = {5, 4, 3, 2, 1, nan, 0, -1, -2, -3, nan};
+  expectMatchesScalar(leadingNan, 0.0f);
+  expectMatchesScalar(innerNan, 0.0f);
+  expectMatchesScalar(innerNan, nan);
+
+  std::vector<double> doubles = {3, 2, std::nan(""), 1, 0, -1};
+  expectMatchesScalar(doubles, 1.0);
+}
+
+TEST(BatchCompareTest, custom_policy) {
+  Comparator<int, FunctionCompare<int>> comparator(
+      [](const int& a, const int& b) { return a == b ? 0 : (a > b ? -1 : 1); });
+  std::vector<int> values = {3, 9, 1, 9, 4};
+  std::vector<int> results(values.size());
+
+  comparator.compareMany(4, values.data(), values.size(), results.data());
+
+  EXPECT_EQ(results, std::vector<int>({1, -1, 1, -1, 0}));
+  EXPECT_EQ(comparator.minIndex(values.data(), values.size()), 1);
+}
@@ -257,7 +257,9 @@ TEST(BinarySearchTreeNodeTest, object_as_node_values) {
   Obj obj2({"obj2", 2});
   Obj obj3({"obj3", 3});
 
-  auto bstNode = std::make_shared<BinarySearchTreeNode<Obj>>(
+  using ObjNode = BinarySearchTreeNode<Obj, FunctionCompare<Obj>>;
+
+  auto bstNode = std::make_shared<ObjNode>(
       obj2, [](const Obj &a, const Obj &b) {
         if (a.key_ == b.key_) {
           return 0;
@@ -20,7 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <string>
 #include "binary_search_tree.hpp"
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(BinarySearchTreeTest, create) {
@@ -98,8 +100,8 @@ TEST(BinarySearchTreeTest, insert_object) {
   Obj obj2({"obj2", 2});
   Obj obj3({"obj3", 3});
 
-  auto bst =
-      std::make_shared<BinarySearchTree<Obj>>([](const Obj &a, const Obj &b) {
+  auto bst = std::make_shared<BinarySearchTree<Obj, FunctionCompare<Obj>>>(
+      [](const Obj &a, const Obj &b) {
         if (a.key_ == b.key_) {
           return 0;
         }
@@ -132,3 +134,60 @@ TEST(BinarySearchTreeTest, traversed_to_sorted_array) {
   EXPECT_EQ(bst->toString(), "-20,-10,4,6,10,20,25");
   EXPECT_EQ(bst->root_->height(), 3);
 }
+
+TEST(BinarySearchTreeTest, contains_does_not_allocate) {
+  BinarySearchTree<int> tree;
+
+  tree.insert(10);
+  tree.insert(5);
+  tree.insert(15);
+
+  EXPECT_NO_ALLOC(EXPECT_TRUE(tree.contains(15)));
+  EXPECT_NO_ALLOC(EXPECT_FALSE(tree.contains(7)));
+}
+
+namespace BinarySearchTreeTest {
+// Orders strings by length and counts how often a key is extracted.
+struct CountingLength {
+  std::size_t operator()(const std::string& value) const {
+    ++*calls_;
+    return value.size();
+  }
+
+  int* calls_;
+};
+}  // namespace BinarySearchTreeTest
+
+TEST(BinarySearchTreeTest, projection_caches_keys) {
+  int calls = 0;
+  using compare_t =
+      ProjectionCompare<std::string, BinarySearchTreeTest::CountingLength>;
+  BinarySearchTree<std::string, compare_t> bst(
+      compare_t(BinarySearchTreeTest::CountingLength{&calls}));
+
+  bst.insert("cccc");
+  bst.insert("bb");
+  bst.insert("eeeeee");
+  bst.insert("a");
+  bst.insert("ddddd");
+  bst.insert("fffffff");
+  EXPECT_EQ(calls, 6);
+  EXPECT_EQ(bst.toString(), "a,bb,cccc,ddddd,eeeeee,fffffff");
+
+  EXPECT_TRUE(bst.contains("zzzzz"));
+  EXPECT_FALSE(bst.contains("zzz"));
+  EXPECT_EQ(calls, 8);
+
+  // Removing nodes moves values around, their keys must follow.
+  bst.remove("xxxx");
+  bst.remove("yy");
+  EXPECT_EQ(bst.toString(), "a,ddddd,eeeeee,fffffff");
+  EXPECT_TRUE(bst.contains("v"));
+  EXPECT_TRUE(bst.contains("vvvvv"));
+  EXPECT_FALSE(bst.contains("vvvv"));
+  bst.remove("q");
+  bst.remove("qqqqq");
+  EXPECT_EQ(bst.toString(), "eeeeee,fffffff");
+  EXPECT_TRUE(bst.contains("pppppp"));
+  EXPECT_TRUE(bst.contains("ppppppp"));
+}
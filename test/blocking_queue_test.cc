@@ -0,0 +1,185 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "blocking_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+TEST(BlockingQueueTest, enqueue_dequeue) {
+  BlockingQueue<std::unique_ptr<std::string>> queue;
+  std::unique_ptr<std::string> value;
+
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_FALSE(queue.tryDequeue(value));
+
+  EXPECT_TRUE(queue.emplace(new std::string("a")));
+  EXPECT_TRUE(queue.enqueue(
+      std::unique_ptr<std::string>(new std::string("b"))));
+  EXPECT_EQ(queue.size(), 2u);
+
+  EXPECT_TRUE(queue.dequeue(value));
+  EXPECT_EQ(*value, "a");
+  EXPECT_TRUE(queue.tryDequeue(value));
+  EXPECT_EQ(*value, "b");
+}
+
+TEST(BlockingQueueTest, dequeue_timeout) {
+  BlockingQueue<int> queue;
+  int value = -1;
+  std::vector<int> values(4);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(queue.dequeueFor(value, std::chrono::milliseconds(20)));
+  EXPECT_EQ(queue.dequeueBulkFor(values.data(), 4,
+                                 std::chrono::milliseconds(20)),
+            0u);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(40));
+  EXPECT_EQ(value, -1);
+
+  queue.enqueue(1);
+  EXPECT_TRUE(queue.dequeueFor(value, std::chrono::milliseconds(20)));
+  EXPECT_EQ(value, 1);
+}
+
+TEST(BlockingQueueTest, consumer_waits_for_producer) {
+  BlockingQueue<int> queue;
+  int value = -1;
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.enqueue(7);
+  });
+
+  EXPECT_TRUE(queue.dequeue(value));
+  EXPECT_EQ(value, 7);
+  producer.join();
+}
+
+TEST(BlockingQueueTest, producer_waits_for_room) {
+  BlockingQueue<int> queue(2);
+  std::atomic<bool> enqueued(false);
+
+  EXPECT_TRUE(queue.tryEnqueue(1));
+  EXPECT_TRUE(queue.tryEnqueue(2));
+  EXPECT_FALSE(queue.tryEnqueue(3));
+
+  std::thread producer([&]() {
+    queue.enqueue(3);
+    enqueued = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(enqueued);
+
+  int value;
+  EXPECT_TRUE(queue.dequeue(value));
+  producer.join();
+  EXPECT_TRUE(enqueued);
+  EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(BlockingQueueTest, bulk) {
+  BlockingQueue<int> queue(4);
+  std::vector<int> values = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<int> received;
+
+  // The producer has to wait for room twice.
+  std::thread producer([&]() {
+    EXPECT_EQ(queue.enqueueBulk(values.data(), values.size()), 10u);
+    queue.close();
+  });
+
+  int batch[3];
+  while (auto count = queue.dequeueBulk(batch, 3)) {
+    EXPECT_LE(count, 3u);
+    received.insert(received.end(), batch, batch + count);
+  }
+
+  producer.join();
+  EXPECT_EQ(received, values);
+}
+
+TEST(BlockingQueueTest, close_wakes_waiters) {
+  BlockingQueue<int> queue(1);
+  queue.enqueue(1);
+
+  std::thread producer([&]() { EXPECT_FALSE(queue.enqueue(2)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  producer.join();
+
+  // Values left are still handed out.
+  int value;
+  EXPECT_TRUE(queue.dequeue(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_FALSE(queue.dequeue(value));
+  EXPECT_FALSE(queue.tryEnqueue(3));
+  EXPECT_TRUE(queue.isClosed());
+}
+
+TEST(BlockingQueueTest, pipeline) {
+  const int threadCount = 3;
+  const int perProducer = 10000;
+  BlockingQueue<int> queue(64);
+  std::atomic<long long> sum(0);
+  std::vector<std::thread> producers;
+  std::vector<std::thread> consumers;
+
+  for (int p = 0; p < threadCount; ++p) {
+    producers.emplace_back([&, p]() {
+      for (int i = p; i < threadCount * perProducer; i += threadCount) {
+        queue.enqueue(i);
+      }
+    });
+  }
+
+  for (int c = 0; c < threadCount; ++c) {
+    consumers.emplace_back([&, c]() {
+      int batch[16];
+      int value;
+      while (true) {
+        if (c % 2) {
+          auto count = queue.dequeueBulk(batch, 16);
+          if (!count) break;
+          for (std::size_t i = 0; i < count; ++i) sum += batch[i];
+        } else {
+          if (!queue.dequeue(value)) break;
+          sum += value;
+        }
+      }
+    });
+  }
+
+  for (auto& producer : producers) producer.join();
+  queue.close();
+  for (auto& consumer : consumers) consumer.join();
+
+  long long total = threadCount * perProducer;
+  EXPECT_EQ(sum, total * (total - 1) / 2);
+}
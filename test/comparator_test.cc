@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <string>
 #include "comparator.hpp"
 #include "gtest/gtest.h"
 
@@ -46,7 +47,7 @@ TEST(ComparatorTest, comapre_default) {
 }
 
 TEST(ComparatorTest, comapre_custom) {
-  Comparator<std::string> comparator(
+  Comparator<std::string, FunctionCompare<std::string>> comparator(
       [](const std::string &a, const std::string &b) {
         if (a.length() == b.length()) {
           return 0;
@@ -71,3 +72,52 @@ TEST(ComparatorTest, comapre_custom) {
   EXPECT_FALSE(comparator.greaterThanOrEqual("aa", "a"));
   EXPECT_TRUE(comparator.greaterThanOrEqual("a", "a"));
 }
+
+TEST(ComparatorTest, compare_function_default) {
+  Comparator<int, FunctionCompare<int>> comparator;
+  Comparator<int, FunctionCompare<int>> comparator2(nullptr);
+
+  EXPECT_FALSE(comparator);
+  EXPECT_FALSE(comparator2);
+  EXPECT_TRUE(comparator.lessThan(1, 2));
+  EXPECT_TRUE(comparator2.equal(2, 2));
+  EXPECT_EQ(comparator.compare(2, 1), 1);
+}
+
+namespace ComparatorTest {
+struct AbsCompare {
+  int operator()(int a, int b) const {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    if (a == b) return 0;
+
+    return a < b ? -1 : 1;
+  }
+};
+}  // namespace ComparatorTest
+
+TEST(ComparatorTest, compare_policy) {
+  Comparator<int, ComparatorTest::AbsCompare> comparator;
+
+  EXPECT_TRUE(comparator.equal(-1, 1));
+  EXPECT_TRUE(comparator.lessThan(1, -2));
+  EXPECT_TRUE(comparator.greaterThan(-3, 2));
+  EXPECT_TRUE(comparator.lessThanOrEqual(-2, 2));
+  EXPECT_EQ(comparator.compare(-2, 1), 1);
+}
+
+TEST(ComparatorTest, projection_compare) {
+  auto byLength = makeProjectionCompare<std::string>(
+      [](const std::string& value) { return value.size(); });
+  Comparator<std::string, decltype(byLength)> comparator(byLength);
+
+  EXPECT_TRUE(comparator.equal("ab", "cd"));
+  EXPECT_TRUE(comparator.lessThan("zz", "aaa"));
+  EXPECT_EQ(comparator.key("abc"), 3);
+  EXPECT_EQ(comparator.compareKeys(4, 2), 1);
+
+  // Plain policies use the value as its key.
+  Comparator<int> intComparator;
+  const int value = 5;
+  EXPECT_EQ(&intComparator.key(value), &value);
+}
@@ -0,0 +1,174 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "concurrent_list_set.hpp"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+namespace {
+
+// Counts the values alive, to catch nodes that are leaked or freed twice.
+struct Counted {
+  explicit Counted(int value) : value_(value) { ++alive_; }
+  Counted(const Counted& other) : value_(other.value_) { ++alive_; }
+  ~Counted() { --alive_; }
+
+  bool operator==(const Counted& other) const {
+    return value_ == other.value_;
+  }
+  bool operator<(const Counted& other) const { return value_ < other.value_; }
+
+  int value_;
+  static std::atomic<int> alive_;
+};
+
+std::atomic<int> Counted::alive_(0);
+
+}  // namespace
+
+TEST(ConcurrentListSetTest, insert_contains_remove) {
+  ConcurrentListSet<int> set;
+  EXPECT_TRUE(set.isEmpty());
+
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_TRUE(set.insert(2));
+  EXPECT_FALSE(set.insert(2));
+  EXPECT_EQ(set.toArray(), std::vector<int>({1, 2, 3}));
+
+  EXPECT_TRUE(set.contains(1));
+  EXPECT_TRUE(set.contains(3));
+  EXPECT_FALSE(set.contains(4));
+
+  EXPECT_TRUE(set.remove(2));
+  EXPECT_FALSE(set.remove(2));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_EQ(set.toArray(), std::vector<int>({1, 3}));
+
+  EXPECT_TRUE(set.insert(2));
+  EXPECT_TRUE(set.remove(1));
+  EXPECT_TRUE(set.remove(3));
+  EXPECT_EQ(set.toArray(), std::vector<int>({2}));
+}
+
+TEST(ConcurrentListSetTest, custom_compare) {
+  ConcurrentListSet<std::string, FunctionCompare<std::string>> set(
+      [](const std::string& a, const std::string& b) {
+        return static_cast<int>(a.size()) - static_cast<int>(b.size());
+      });
+
+  EXPECT_TRUE(set.insert("ccc"));
+  EXPECT_TRUE(set.insert(1, 'a'));
+  EXPECT_FALSE(set.insert("bbb"));
+  EXPECT_TRUE(set.contains("zzz"));
+  EXPECT_EQ(set.toArray(), std::vector<std::string>({"a", "ccc"}));
+}
+
+TEST(ConcurrentListSetTest, concurrent_inserts) {
+  const int threadCount = 4;
+  const int perThread = 500;
+  ConcurrentListSet<int> set;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&set, t]() {
+      for (int i = 0; i < perThread; ++i) {
+        EXPECT_TRUE(set.insert(i * threadCount + t));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto values = set.toArray();
+  ASSERT_EQ(values.size(), static_cast<std::size_t>(threadCount * perThread));
+  for (int i = 0; i < threadCount * perThread; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(ConcurrentListSetTest, concurrent_writers_and_readers) {
+  const int keyCount = 64;
+
+  {
+    ConcurrentListSet<Counted> set;
+    std::atomic<bool> stop(false);
+    std::atomic<int> inserted(0);
+    std::atomic<int> removed(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int round = 0; round < 200; ++round) {
+          for (int key = t; key < keyCount; key += 2) {
+            if (set.insert(key)) ++inserted;
+            if (set.remove(Counted(key + 1))) ++removed;
+          }
+        }
+      });
+    }
+
+    std::thread reader([&]() {
+      while (!stop) {
+        for (int key = 0; key < keyCount; ++key) set.contains(Counted(key));
+        auto values = set.toArray();
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+      }
+    });
+
+    for (auto& thread : threads) thread.join();
+    stop = true;
+    reader.join();
+
+    auto values = set.toArray();
+    EXPECT_EQ(static_cast<int>(values.size()), inserted - removed);
+    for (std::size_t i = 1; i < values.size(); ++i) {
+      EXPECT_LT(values[i - 1].value_, values[i].value_);
+    }
+  }
+
+  EXPECT_EQ(Counted::alive_, 0);
+}
+
+TEST(ConcurrentListSetTest, reclaim_removed_nodes) {
+  {
+    ConcurrentListSet<Counted> set;
+
+    for (int i = 0; i < 1000; ++i) {
+      set.insert(i);
+      set.remove(Counted(i));
+    }
+
+    // Only the nodes retired since the last collection are left.
+    EXPECT_LE(Counted::alive_, static_cast<int>(
+                                    2 * EpochReclaimer::COLLECT_INTERVAL));
+    set.reclaimer().collect();
+    set.reclaimer().collect();
+    EXPECT_EQ(Counted::alive_, 0);
+  }
+
+  EXPECT_EQ(Counted::alive_, 0);
+}
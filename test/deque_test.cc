@@ -0,0 +1,269 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "deque.hpp"
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+TEST(DequeTest, create_empty) {
+  Deque<int> deque;
+
+  EXPECT_TRUE(deque.isEmpty());
+  EXPECT_EQ(deque.front(), nullptr);
+  EXPECT_EQ(deque.back(), nullptr);
+  EXPECT_EQ(deque.toString(), "");
+}
+
+TEST(DequeTest, push_both_ends) {
+  Deque<int, 4> deque;
+
+  for (int i = 0; i < 10; ++i) {
+    deque.pushBack(i);
+    deque.pushFront(-i - 1);
+  }
+
+  EXPECT_EQ(deque.size(), 20u);
+  EXPECT_EQ(*deque.front(), -10);
+  EXPECT_EQ(*deque.back(), 9);
+  EXPECT_EQ(deque.toString(),
+            "-10,-9,-8,-7,-6,-5,-4,-3,-2,-1,0,1,2,3,4,5,6,7,8,9");
+}
+
+TEST(DequeTest, index) {
+  Deque<int, 4> deque;
+  for (int i = 0; i < 50; ++i) deque.pushBack(i);
+  for (int i = 0; i < 7; ++i) deque.popFront();
+
+  for (std::size_t i = 0; i < deque.size(); ++i) {
+    EXPECT_EQ(deque[i], static_cast<int>(i) + 7);
+  }
+
+  deque[0] = 100;
+  const Deque<int, 4>& view = deque;
+  EXPECT_EQ(view[0], 100);
+  EXPECT_EQ(*view.front(), 100);
+}
+
+TEST(DequeTest, pop_both_ends) {
+  Deque<std::string, 2> deque;
+  deque.pushBack("b");
+  deque.pushBack("c");
+  deque.pushFront("a");
+
+  EXPECT_EQ(deque.popBack(), "c");
+  EXPECT_EQ(deque.popFront(), "a");
+  EXPECT_EQ(deque.popFront(), "b");
+  EXPECT_TRUE(deque.isEmpty());
+  EXPECT_EQ(deque.popFront(), "");
+  EXPECT_EQ(deque.popBack(), "");
+}
+
+TEST(DequeTest, try_pop) {
+  Deque<int> deque;
+  int value = 7;
+
+  EXPECT_FALSE(deque.tryPopFront(value));
+  EXPECT_FALSE(deque.tryPopBack(value));
+  EXPECT_EQ(value, 7);
+
+  deque.pushBack(1);
+  deque.pushBack(2);
+  EXPECT_TRUE(deque.tryPopBack(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(deque.tryPopFront(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(deque.isEmpty());
+}
+
+TEST(DequeTest, move_only) {
+  Deque<std::unique_ptr<int>, 2> deque;
+
+  deque.pushBack(std::unique_ptr<int>(new int(2)));
+  deque.emplaceFront(new int(1));
+  deque.emplaceBack(new int(3));
+
+  EXPECT_EQ(*deque.popFront(), 1);
+  EXPECT_EQ(*deque.popBack(), 3);
+  EXPECT_EQ(*deque.popBack(), 2);
+}
+
+TEST(DequeTest, references_stay_valid) {
+  Deque<std::string, 4> deque;
+  std::string& first = deque.emplaceBack("first");
+  std::string& last = deque.emplaceFront("last");
+  std::vector<const std::string*> addresses;
+
+  for (int i = 0; i < 1000; ++i) {
+    addresses.push_back(&deque.emplaceBack(std::to_string(i)));
+    deque.pushFront(std::to_string(-i));
+  }
+
+  EXPECT_EQ(first, "first");
+  EXPECT_EQ(last, "last");
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(*addresses[i], std::to_string(i));
+  }
+}
+
+TEST(DequeTest, emplace_own_value) {
+  Deque<std::string, 2> deque;
+  deque.pushBack("a");
+
+  for (int i = 0; i < 20; ++i) {
+    deque.emplaceBack(*deque.front());
+    deque.emplaceFront(*deque.back());
+  }
+
+  EXPECT_EQ(deque.size(), 41u);
+  EXPECT_EQ(deque.toArray(), std::vector<std::string>(41, "a"));
+}
+
+TEST(DequeTest, sliding_window_does_not_allocate) {
+  Deque<std::string, 8, OperationStats> deque;
+  for (int i = 0; i < 100; ++i) deque.emplaceBack(4, 'a');
+  std::string value;
+
+  // Warm up, so the spare chunks reach the back of the map.
+  for (int i = 0; i < 1000; ++i) {
+    deque.emplaceBack(4, 'b');
+    deque.tryPopFront(value);
+  }
+  auto allocations = deque.stats().allocations_;
+
+  EXPECT_NO_ALLOC(for (int i = 0; i < 10000; ++i) {
+    deque.emplaceBack(4, 'c');
+    deque.tryPopFront(value);
+  });
+  EXPECT_NO_ALLOC(for (int i = 0; i < 10000; ++i) {
+    deque.emplaceFront(4, 'c');
+    deque.tryPopBack(value);
+  });
+  EXPECT_EQ(deque.stats().allocations_, allocations);
+  EXPECT_EQ(deque.size(), 100u);
+}
+
+TEST(DequeTest, clear_keeps_chunks) {
+  Deque<int, 16, OperationStats> deque;
+  for (int i = 0; i < 100; ++i) deque.pushBack(i);
+  auto allocations = deque.stats().allocations_;
+
+  deque.clear();
+  EXPECT_TRUE(deque.isEmpty());
+  for (int i = 0; i < 40; ++i) {
+    deque.pushBack(i);
+    deque.pushFront(i);
+  }
+  EXPECT_EQ(deque.stats().allocations_, allocations);
+
+  deque.clear();
+  deque.shrinkToFit();
+  deque.pushBack(1);
+  EXPECT_EQ(deque.stats().allocations_, allocations + 1);
+  EXPECT_EQ(deque.toString(), "1");
+}
+
+TEST(DequeTest, zero_one_bfs) {
+  // Edges of weight 0 go right and weight 1 go down on a 20 by 20 grid, so
+  // the distance to a cell is its row.
+  const int side = 20;
+  std::vector<int> distance(side * side, -1);
+  Deque<std::pair<int, int>> deque;
+  deque.pushBack(std::make_pair(0, 0));
+
+  while (!deque.isEmpty()) {
+    auto entry = deque.popFront();
+    auto cell = entry.first;
+    if (distance[cell] != -1) continue;
+    distance[cell] = entry.second;
+
+    if (cell % side + 1 < side) {
+      deque.pushFront(std::make_pair(cell + 1, entry.second));
+    }
+    if (cell + side < side * side) {
+      deque.pushBack(std::make_pair(cell + side, entry.second + 1));
+    }
+  }
+
+  for (int cell = 0; cell < side * side; ++cell) {
+    EXPECT_EQ(distance[cell], cell / side);
+  }
+}
+
+TEST(DequeTest, matches_std_deque) {
+  Deque<int, 4> deque;
+  std::deque<int> expected;
+  std::mt19937 random(7);
+
+  for (int i = 0; i < 20000; ++i) {
+    switch (random() % 4) {
+      case 0:
+        deque.pushBack(i);
+        expected.push_back(i);
+        break;
+      case 1:
+        deque.pushFront(i);
+        expected.push_front(i);
+        break;
+      case 2:
+        EXPECT_EQ(deque.popBack(), expected.empty() ? 0 : expected.back());
+        if (!expected.empty()) expected.pop_back();
+        break;
+      default:
+        EXPECT_EQ(deque.popFront(), expected.empty() ? 0 : expected.front());
+        if (!expected.empty()) expected.pop_front();
+        break;
+    }
+  }
+
+  ASSERT_EQ(deque.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(deque[i], expected[i]);
+  }
+}
+
+TEST(DequeTest, copy_and_move) {
+  Deque<std::string, 4> deque;
+  for (int i = 0; i < 20; ++i) deque.pushBack(std::to_string(i));
+  for (int i = 0; i < 10; ++i) deque.popFront();
+
+  Deque<std::string, 4> copy(deque);
+  EXPECT_EQ(copy.toString(), deque.toString());
+  EXPECT_EQ(copy.popFront(), "10");
+  EXPECT_EQ(*deque.front(), "10");
+
+  Deque<std::string, 4> moved(std::move(copy));
+  EXPECT_TRUE(copy.isEmpty());
+  EXPECT_EQ(moved.size(), 9u);
+
+  copy = moved;
+  moved = Deque<std::string, 4>();
+  EXPECT_EQ(copy.popBack(), "19");
+  EXPECT_TRUE(moved.isEmpty());
+  copy.pushFront("x");
+  EXPECT_EQ(copy.toString(), "x,11,12,13,14,15,16,17,18");
+}
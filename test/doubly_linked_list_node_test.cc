@@ -0,0 +1,69 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "doubly_linked_list_node.hpp"
+#include <string>
+#include <utility>
+#include "gtest/gtest.h"
+
+TEST(DoublyLinkedListNodeTest, create_with_value) {
+  DoublyLinkedListNode<int> node(1);
+
+  EXPECT_EQ(node.value_, 1);
+  EXPECT_EQ(node.next_, nullptr);
+  EXPECT_EQ(node.previous_.lock(), nullptr);
+}
+
+TEST(DoublyLinkedListNodeTest, create_with_object) {
+  auto obj = std::make_pair(1, "test");
+
+  DoublyLinkedListNode<std::pair<int, std::string>> node(obj);
+
+  EXPECT_EQ(node.value_.first, obj.first);
+  EXPECT_EQ(node.value_.second, obj.second);
+  EXPECT_EQ(node.next_, nullptr);
+}
+
+TEST(DoublyLinkedListNodeTest, link) {
+  auto node2 = std::make_shared<DoublyLinkedListNode<int>>(2);
+  auto node1 = std::make_shared<DoublyLinkedListNode<int>>(1, node2);
+  node2->previous_ = node1;
+
+  EXPECT_EQ(node1->next_->value_, 2);
+  EXPECT_EQ(node2->previous_.lock()->value_, 1);
+  EXPECT_EQ(node2->next_, nullptr);
+
+  // The back link does not keep the previous node alive.
+  std::weak_ptr<DoublyLinkedListNode<int>> weakNode1 = node1;
+  node1.reset();
+  EXPECT_TRUE(weakNode1.expired());
+  EXPECT_TRUE(node2->previous_.expired());
+}
+
+TEST(DoublyLinkedListNodeTest, to_string) {
+  DoublyLinkedListNode<int> node(1);
+
+  auto doubled = [](int value) { return std::to_string(value * 2); };
+
+  EXPECT_EQ(node.toString(), "1");
+  EXPECT_EQ(node.toString(doubled), "2");
+}
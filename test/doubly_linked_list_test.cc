@@ -0,0 +1,270 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "doubly_linked_list.hpp"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace DoublyLinkedListTest {
+// Checks that the back links mirror the forward links.
+template <typename List>
+void expectLinked(const List& list) {
+  std::shared_ptr<typename List::node_t> previousNode = nullptr;
+  for (auto node = list.head_; node; node = node->next_) {
+    EXPECT_EQ(node->previous_.lock(), previousNode);
+    previousNode = node;
+  }
+  EXPECT_EQ(list.tail_, previousNode);
+}
+}  // namespace DoublyLinkedListTest
+
+using DoublyLinkedListTest::expectLinked;
+
+TEST(DoublyLinkedListTest, create_empty) {
+  DoublyLinkedList<int> list;
+
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+  EXPECT_EQ(list.toString(), "");
+}
+
+TEST(DoublyLinkedListTest, append_and_prepend) {
+  DoublyLinkedList<int> list;
+
+  list.append(2).append(3).prepend(1).prepend(0);
+
+  EXPECT_EQ(list.toString(), "0,1,2,3");
+  EXPECT_EQ(list.head_->value_, 0);
+  EXPECT_EQ(list.tail_->value_, 3);
+  expectLinked(list);
+}
+
+TEST(DoublyLinkedListTest, remove_by_value) {
+  DoublyLinkedList<int> list;
+
+  list.append(1).append(1).append(2).append(3).append(1).append(4);
+
+  auto deletedNode = list.remove(1);
+  EXPECT_EQ(deletedNode->value_, 1);
+  EXPECT_EQ(deletedNode->next_, nullptr);
+  EXPECT_EQ(list.toString(), "2,3,4");
+  expectLinked(list);
+
+  EXPECT_EQ(list.remove(5), nullptr);
+  list.remove(4);
+  EXPECT_EQ(list.toString(), "2,3");
+  expectLinked(list);
+
+  list.remove(2);
+  list.remove(3);
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+}
+
+TEST(DoublyLinkedListTest, delete_tail) {
+  DoublyLinkedList<int, DefaultCompare<int>, OperationStats> list;
+
+  list.append(1).append(2).append(3);
+
+  EXPECT_EQ(list.deleteTail()->value_, 3);
+  EXPECT_EQ(list.toString(), "1,2");
+  expectLinked(list);
+
+  EXPECT_EQ(list.deleteTail()->value_, 2);
+  EXPECT_EQ(list.deleteTail()->value_, 1);
+  EXPECT_EQ(list.deleteTail(), nullptr);
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+
+  // The predecessor of the tail is known without walking the list.
+  EXPECT_EQ(list.stats().node_visits_, 0);
+}
+
+TEST(DoublyLinkedListTest, delete_head) {
+  DoublyLinkedList<int> list;
+
+  EXPECT_EQ(list.deleteHead(), nullptr);
+
+  list.append(1).append(2);
+
+  EXPECT_EQ(list.deleteHead()->value_, 1);
+  EXPECT_EQ(list.toString(), "2");
+  expectLinked(list);
+
+  EXPECT_EQ(list.deleteHead()->value_, 2);
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+}
+
+TEST(DoublyLinkedListTest, unlink) {
+  DoublyLinkedList<int> list;
+
+  list.append(1).append(2).append(3).append(4);
+
+  auto node = list.find(2);
+  EXPECT_EQ(list.unlink(node), node);
+  EXPECT_EQ(node->next_, nullptr);
+  EXPECT_TRUE(node->previous_.expired());
+  EXPECT_EQ(list.toString(), "1,3,4");
+  expectLinked(list);
+
+  list.unlink(list.head_);
+  list.unlink(list.tail_);
+  EXPECT_EQ(list.toString(), "3");
+  expectLinked(list);
+
+  list.unlink(list.head_);
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+}
+
+TEST(DoublyLinkedListTest, unlink_rejects_foreign_nodes) {
+  DoublyLinkedList<int> list;
+  DoublyLinkedList<int> other;
+
+  list.append(1).append(2);
+  other.append(3).append(4);
+
+  auto detached = list.unlink(list.find(1));
+  EXPECT_EQ(list.unlink(detached), nullptr);
+  EXPECT_EQ(list.unlink(other.head_), nullptr);
+  EXPECT_EQ(list.unlink(other.tail_), nullptr);
+  EXPECT_EQ(list.unlink(nullptr), nullptr);
+  list.moveToFront(other.tail_);
+
+  EXPECT_EQ(list.toString(), "2");
+  EXPECT_EQ(other.toString(), "3,4");
+  expectLinked(list);
+  expectLinked(other);
+}
+
+TEST(DoublyLinkedListTest, copy_and_move) {
+  DoublyLinkedList<int> list;
+  list.append(1).append(2).append(3);
+
+  DoublyLinkedList<int> copy(list);
+  copy.unlink(copy.find(2));
+  copy.append(4);
+  EXPECT_EQ(list.toString(), "1,2,3");
+  EXPECT_EQ(copy.toString(), "1,3,4");
+  expectLinked(list);
+  expectLinked(copy);
+
+  list = copy;
+  list.moveToFront(list.tail_);
+  EXPECT_EQ(list.toString(), "4,1,3");
+  EXPECT_EQ(copy.toString(), "1,3,4");
+
+  DoublyLinkedList<int> moved(std::move(list));
+  copy = std::move(moved);
+  EXPECT_EQ(copy.toString(), "4,1,3");
+  expectLinked(copy);
+}
+
+TEST(DoublyLinkedListTest, move_to_front) {
+  DoublyLinkedList<int> list;
+
+  list.append(1).append(2).append(3);
+
+  list.moveToFront(list.find(2));
+  EXPECT_EQ(list.toString(), "2,1,3");
+  expectLinked(list);
+
+  list.moveToFront(list.tail_);
+  EXPECT_EQ(list.toString(), "3,2,1");
+  expectLinked(list);
+
+  list.moveToFront(list.head_);
+  EXPECT_EQ(list.toString(), "3,2,1");
+  expectLinked(list);
+}
+
+TEST(DoublyLinkedListTest, find) {
+  DoublyLinkedList<std::string> list;
+
+  EXPECT_EQ(list.find("a"), nullptr);
+
+  list.append("a").append("bb").append("ccc");
+
+  auto isLong = [](const std::string& value) { return value.size() == 3; };
+
+  EXPECT_EQ(list.find("bb")->value_, "bb");
+  EXPECT_EQ(list.find(isLong)->value_, "ccc");
+  EXPECT_EQ(list.find(std::function<bool(const std::string&)>()), nullptr);
+}
+
+TEST(DoublyLinkedListTest, append_move_only) {
+  DoublyLinkedList<std::unique_ptr<int>> list;
+
+  list.append(std::unique_ptr<int>(new int(1)));
+  list.emplacePrepend(new int(0));
+
+  EXPECT_EQ(*list.head_->value_, 0);
+  EXPECT_EQ(*list.tail_->value_, 1);
+}
+
+TEST(DoublyLinkedListTest, iterate) {
+  DoublyLinkedList<int> list;
+
+  EXPECT_EQ(list.begin(), list.end());
+
+  list.append(1).append(2).append(3);
+
+  std::vector<int> values(list.begin(), list.end());
+  EXPECT_EQ(values, std::vector<int>({1, 2, 3}));
+
+  list.moveToFront(list.tail_);
+  const auto& constList = list;
+  values.assign(constList.begin(), constList.end());
+  EXPECT_EQ(values, std::vector<int>({3, 1, 2}));
+}
+
+TEST(DoublyLinkedListTest, values) {
+  DoublyLinkedList<std::string> list;
+
+  EXPECT_TRUE(list.values().empty());
+
+  list.append("a").append("b").append("c");
+  list.moveToFront(list.tail_);
+
+  // Only the values are copied, the nodes keep their reference counts.
+  EXPECT_EQ(list.values(), std::vector<std::string>({"c", "a", "b"}));
+  EXPECT_EQ(list.head_.use_count(), 1);
+  EXPECT_EQ(list.tail_.use_count(), 2);
+}
+
+TEST(DoublyLinkedListTest, clear) {
+  DoublyLinkedList<int> list;
+  for (int i = 0; i < 1000000; ++i) {
+    list.append(i);
+  }
+
+  list.clear();
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+
+  list.append(1);
+  EXPECT_EQ(list.toString(), "1");
+}
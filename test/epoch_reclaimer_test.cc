@@ -0,0 +1,140 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "epoch_reclaimer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+namespace {
+
+struct Tracked : EpochReclaimer::Retired {
+  explicit Tracked(int* destroyed)
+      : EpochReclaimer::Retired(&Tracked::destroy), destroyed_(destroyed) {}
+
+  static void destroy(EpochReclaimer::Retired* retired) {
+    auto tracked = static_cast<Tracked*>(retired);
+    ++*tracked->destroyed_;
+    delete tracked;
+  }
+
+  int* destroyed_;
+};
+
+}  // namespace
+
+TEST(EpochReclaimerTest, reclaim_without_guards) {
+  int destroyed = 0;
+  EpochReclaimer reclaimer;
+
+  reclaimer.retire(new Tracked(&destroyed));
+  reclaimer.collect();
+  EXPECT_EQ(destroyed, 0);
+
+  reclaimer.collect();
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(reclaimer.epoch(), 3u);
+}
+
+TEST(EpochReclaimerTest, guard_holds_back_reclamation) {
+  int destroyed = 0;
+  EpochReclaimer reclaimer;
+
+  {
+    EpochReclaimer::Guard guard(reclaimer);
+    EpochReclaimer::Guard nested(reclaimer);
+    reclaimer.retire(new Tracked(&destroyed));
+
+    for (int i = 0; i < 4; ++i) reclaimer.collect();
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(reclaimer.epoch(), 2u);
+  }
+
+  reclaimer.collect();
+  reclaimer.collect();
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(EpochReclaimerTest, guard_of_other_thread) {
+  int destroyed = 0;
+  EpochReclaimer reclaimer;
+  std::mutex mutex;
+  std::condition_variable changed;
+  bool pinned = false;
+  bool done = false;
+
+  std::thread reader([&]() {
+    EpochReclaimer::Guard guard(reclaimer);
+    std::unique_lock<std::mutex> lock(mutex);
+    pinned = true;
+    changed.notify_all();
+    changed.wait(lock, [&]() { return done; });
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&]() { return pinned; });
+  }
+
+  reclaimer.retire(new Tracked(&destroyed));
+  for (int i = 0; i < 4; ++i) reclaimer.collect();
+  EXPECT_EQ(destroyed, 0);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    changed.notify_all();
+  }
+  reader.join();
+
+  reclaimer.collect();
+  reclaimer.collect();
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(EpochReclaimerTest, collect_periodically) {
+  int destroyed = 0;
+  EpochReclaimer reclaimer;
+
+  for (std::size_t i = 0; i < 4 * EpochReclaimer::COLLECT_INTERVAL; ++i) {
+    reclaimer.retire(new Tracked(&destroyed));
+  }
+
+  EXPECT_GT(destroyed, 0);
+  EXPECT_LT(destroyed, static_cast<int>(4 * EpochReclaimer::COLLECT_INTERVAL));
+}
+
+TEST(EpochReclaimerTest, destroy_pending_on_destruction) {
+  int destroyed = 0;
+
+  {
+    EpochReclaimer reclaimer;
+    EpochReclaimer::Guard guard(reclaimer);
+    reclaimer.retire(new Tracked(&destroyed));
+    reclaimer.retire(new Tracked(&destroyed));
+  }
+
+  EXPECT_EQ(destroyed, 2);
+}
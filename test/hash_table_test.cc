@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "hash_table.hpp"
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(HashTableTest, create) {
@@ -111,3 +112,44 @@ TEST(HashTableTest, keys) {
   EXPECT_TRUE(hashTable.has("b"));
   EXPECT_FALSE(hashTable.has("x"));
 }
+
+TEST(HashTableTest, set_move_only) {
+  HashTable<std::unique_ptr<int>> hashTable;
+
+  hashTable.set("a", std::unique_ptr<int>(new int(1)));
+  hashTable.set("a", std::unique_ptr<int>(new int(2)));
+
+  EXPECT_EQ(**hashTable.get("a"), 2);
+}
+
+TEST(HashTableTest, lookups_do_not_allocate) {
+  HashTable<int> hashTable;
+
+  // Longer than the small string buffer, so copying a key would allocate.
+  const std::string key = "a-key-too-long-for-small-strings";
+  const std::string missing = "another-key-too-long-for-small-strings";
+  hashTable.set(key, 1);
+
+  EXPECT_NO_ALLOC(EXPECT_EQ(*hashTable.get(key), 1));
+  EXPECT_NO_ALLOC(EXPECT_EQ(hashTable.get(missing), nullptr));
+  EXPECT_NO_ALLOC(EXPECT_TRUE(hashTable.has(key)));
+  EXPECT_NO_ALLOC(EXPECT_TRUE(hashTable.has(key.data(), key.size())));
+  EXPECT_NO_ALLOC(hashTable.hash(key));
+}
+
+TEST(HashTableTest, clear) {
+  HashTable<int, 4> hashTable;
+  hashTable.set("1", 1);
+
+  // Fills one bucket directly, set() would scan it on every call.
+  for (int i = 0; i < 1000000; ++i) {
+    hashTable.buckets_[0].emplaceAppend("", i);
+  }
+
+  hashTable.clear();
+  EXPECT_FALSE(hashTable.has("1"));
+  EXPECT_TRUE(hashTable.getKeys().empty());
+
+  hashTable.set("a", 1);
+  EXPECT_EQ(*hashTable.get("a"), 1);
+}
@@ -21,7 +21,13 @@
 // SOFTWARE.
 
 #include "linked_list.hpp"
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
 #include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
 
 TEST(LinkedListTest, create_empty) {
   LinkedList<int> list;
@@ -213,7 +219,9 @@ TEST(LinkedListTest, find_by_callback) {
 }
 
 TEST(LinkedListTest, find_by_custom_compare) {
-  LinkedList<std::pair<int, std::string>> list(
+  using Pair = std::pair<int, std::string>;
+
+  LinkedList<Pair, FunctionCompare<Pair>> list(
       [](const std::pair<int, std::string>& a,
          const std::pair<int, std::string>& b) {
         if (a.second == b.second) return 0;
@@ -232,3 +240,219 @@ TEST(LinkedListTest, find_by_custom_compare) {
   EXPECT_EQ(node->value_.second, "test2");
   EXPECT_EQ(list.find(std::make_pair(2, std::string("test5"))), nullptr);
 }
+
+TEST(LinkedListTest, emplace) {
+  LinkedList<std::pair<std::string, int>> list;
+
+  list.emplaceAppend("b", 2);
+  list.emplacePrepend("a", 1);
+
+  EXPECT_EQ(list.head_->value_, std::make_pair(std::string("a"), 1));
+  EXPECT_EQ(list.tail_->value_, std::make_pair(std::string("b"), 2));
+}
+
+TEST(LinkedListTest, append_move_only) {
+  LinkedList<std::unique_ptr<int>> list;
+
+  list.append(std::unique_ptr<int>(new int(1)));
+  list.prepend(std::unique_ptr<int>(new int(0)));
+
+  EXPECT_EQ(*list.head_->value_, 0);
+  EXPECT_EQ(*list.tail_->value_, 1);
+}
+
+TEST(LinkedListTest, find_and_to_string_by_std_function) {
+  LinkedList<int> list;
+
+  list.append(1).append(2);
+
+  std::function<bool(const int&)> isTwo = [](const int& value) {
+    return value == 2;
+  };
+  std::function<std::string(const int&)> format = [](const int& value) {
+    return "#" + std::to_string(value);
+  };
+
+  EXPECT_EQ(list.find(isTwo)->value_, 2);
+  EXPECT_EQ(list.find(std::function<bool(const int&)>()), nullptr);
+  EXPECT_EQ(list.toString(format), "#1,#2");
+  EXPECT_EQ(list.toString(std::function<std::string(const int&)>()),
+            "LinkedListNode,LinkedListNode");
+}
+
+TEST(LinkedListTest, iterate) {
+  LinkedList<int> list;
+
+  EXPECT_EQ(list.begin(), list.end());
+
+  list.append(1).append(2).append(3);
+
+  std::vector<int> values;
+  for (auto& value : list) {
+    values.push_back(value);
+  }
+  EXPECT_EQ(values, std::vector<int>({1, 2, 3}));
+
+  for (auto& value : list) {
+    value *= 10;
+  }
+  EXPECT_EQ(list.toString(), "10,20,30");
+
+  const auto& constList = list;
+  LinkedList<int>::const_iterator it = list.begin();
+  EXPECT_EQ(it, constList.cbegin());
+  EXPECT_EQ(*it++, 10);
+  EXPECT_EQ(*it, 20);
+  EXPECT_EQ(std::distance(constList.begin(), constList.end()), 3);
+  EXPECT_EQ(*std::max_element(constList.begin(), constList.end()), 30);
+}
+
+TEST(LinkedListTest, iterate_without_refcounts) {
+  LinkedList<std::string> list;
+  list.append("a").append("b");
+
+  int total = 0;
+  EXPECT_NO_ALLOC(for (auto& value : list) total += value.size());
+  EXPECT_EQ(total, 2);
+
+  // Only the list holds the nodes while they are walked: the head through
+  // head_, the tail through tail_ and the link of the head.
+  for (auto& value : list) {
+    EXPECT_FALSE(value.empty());
+    EXPECT_EQ(list.head_.use_count(), 1);
+    EXPECT_EQ(list.tail_.use_count(), 2);
+  }
+}
+
+TEST(LinkedListTest, values) {
+  LinkedList<std::string> list;
+
+  EXPECT_TRUE(list.values().empty());
+
+  list.append("a").append("b").append("c");
+  auto node = list.find("b");
+
+  // Only the values are copied, the nodes keep their reference counts.
+  EXPECT_EQ(list.values(), std::vector<std::string>({"a", "b", "c"}));
+  EXPECT_EQ(list.head_.use_count(), 1);
+  EXPECT_EQ(node.use_count(), 2);
+}
+
+TEST(LinkedListTest, clear) {
+  LinkedList<int> list;
+  list.append(1).append(2).append(3);
+
+  auto node = list.find(2);
+  list.clear();
+
+  EXPECT_EQ(list.head_, nullptr);
+  EXPECT_EQ(list.tail_, nullptr);
+  EXPECT_EQ(list.toString(), "");
+
+  // Nodes held from outside keep the rest of their chain.
+  EXPECT_EQ(node->value_, 2);
+  EXPECT_EQ(node->next_->value_, 3);
+
+  list.append(4);
+  EXPECT_EQ(list.toString(), "4");
+}
+
+TEST(LinkedListTest, destroy_long_list) {
+  // Would overflow the stack if the nodes were released recursively.
+  LinkedList<int> list;
+  for (int i = 0; i < 1000000; ++i) {
+    list.append(i);
+  }
+
+  LinkedList<int> other;
+  other.append(0);
+  other = std::move(list);
+  EXPECT_EQ(other.tail_->value_, 999999);
+}
+
+TEST(LinkedListTest, append_range) {
+  LinkedList<int> list;
+  std::vector<int> values = {1, 2, 3};
+
+  list.append(0).appendRange(values.begin(), values.end());
+  EXPECT_EQ(list.toString(), "0,1,2,3");
+  EXPECT_EQ(list.tail_->value_, 3);
+  EXPECT_EQ(list.tail_->next_, nullptr);
+
+  list.appendRange(values.end(), values.end());
+  EXPECT_EQ(list.toString(), "0,1,2,3");
+
+  LinkedList<int> empty;
+  empty.appendRange(values.begin(), values.begin() + 1);
+  EXPECT_EQ(empty.head_, empty.tail_);
+  EXPECT_EQ(empty.toString(), "1");
+}
+
+TEST(LinkedListTest, splice_and_concat) {
+  LinkedList<int> list;
+  LinkedList<int> other;
+  other.append(3).append(4);
+
+  list.splice(other);
+  EXPECT_EQ(list.toString(), "3,4");
+  EXPECT_EQ(list.tail_->value_, 4);
+  EXPECT_EQ(other.head_, nullptr);
+  EXPECT_EQ(other.tail_, nullptr);
+
+  other.append(5);
+  list.splice(other).splice(other).splice(list);
+  EXPECT_EQ(list.toString(), "3,4,5");
+
+  LinkedList<int> last;
+  last.append(6);
+  list.concat(std::move(last)).append(7);
+  EXPECT_EQ(list.toString(), "3,4,5,6,7");
+  EXPECT_EQ(list.tail_->value_, 7);
+}
+
+TEST(LinkedListTest, sort) {
+  LinkedList<int> list;
+  list.sort();
+  EXPECT_EQ(list.head_, nullptr);
+
+  std::vector<int> values = {5, 3, 9, 1, 3, 8, 2, 7, 0, 6, 4, 1};
+  list.appendRange(values.begin(), values.end());
+  auto head = list.head_;
+
+  list.sort();
+  EXPECT_EQ(list.toString(), "0,1,1,2,3,3,4,5,6,7,8,9");
+  EXPECT_EQ(list.tail_->value_, 9);
+  EXPECT_EQ(list.tail_->next_, nullptr);
+
+  // Nodes are relinked, not copied.
+  EXPECT_EQ(list.find(5), head);
+
+  Comparator<int, FunctionCompare<int>> descending(
+      [](const int& a, const int& b) { return b - a; });
+  list.sort(descending);
+  EXPECT_EQ(list.toString(), "9,8,7,6,5,4,3,3,2,1,1,0");
+  EXPECT_EQ(list.tail_->value_, 0);
+}
+
+TEST(LinkedListTest, sort_is_stable) {
+  typedef std::pair<int, int> entry_t;
+  auto byKey = [](const entry_t& a, const entry_t& b) {
+    return a.first - b.first;
+  };
+  LinkedList<entry_t, FunctionCompare<entry_t>> list(byKey);
+
+  std::vector<entry_t> expected;
+  for (int i = 0; i < 1000; ++i) {
+    list.append(entry_t((i * 7919) % 13, i));
+    expected.push_back(entry_t((i * 7919) % 13, i));
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const entry_t& a, const entry_t& b) {
+                     return a.first < b.first;
+                   });
+
+  list.sort();
+  std::vector<entry_t> sorted(list.begin(), list.end());
+  EXPECT_TRUE(sorted == expected);
+  EXPECT_EQ(list.tail_->value_, expected.back());
+}
@@ -20,7 +20,10 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <string>
+#include <vector>
 #include "min_heap.hpp"
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(MinHeapTest, create_empty) {
@@ -178,10 +181,103 @@ TEST(MinHeapTest, remove_with_custom_comparator) {
 
   EXPECT_EQ(minHeap.toString(), "a,bb,ccc,dddd");
 
-  minHeap.remove("hey", Comparator<std::string>(
-                            [](const std::string& a, const std::string& b) {
-                              if (a.length() == b.length()) return 0;
-                              return a.length() < b.length() ? -1 : 1;
-                            }));
+  auto compareLength = [](const std::string& a, const std::string& b) {
+    if (a.length() == b.length()) return 0;
+    return a.length() < b.length() ? -1 : 1;
+  };
+
+  minHeap.remove("hey", Comparator<std::string, FunctionCompare<std::string>>(
+                            compareLength));
   EXPECT_EQ(minHeap.toString(), "a,bb,dddd");
 }
+
+namespace MinHeapTest {
+struct ReverseCompare {
+  int operator()(int a, int b) const {
+    if (a == b) return 0;
+    return a < b ? 1 : -1;
+  }
+};
+}  // namespace MinHeapTest
+
+TEST(MinHeapTest, compare_policy) {
+  MinHeap<int, MinHeapTest::ReverseCompare> maxHeap;
+
+  maxHeap.add(3);
+  maxHeap.add(10);
+  maxHeap.add(5);
+
+  EXPECT_EQ(*maxHeap.peek(), 10);
+  EXPECT_EQ(*maxHeap.poll(), 10);
+  EXPECT_EQ(*maxHeap.poll(), 5);
+  EXPECT_EQ(*maxHeap.poll(), 3);
+
+  MinHeap<int, FunctionCompare<int>> functionHeap(
+      [](const int& a, const int& b) { return b - a; });
+
+  functionHeap.add(3);
+  functionHeap.add(10);
+
+  EXPECT_EQ(*functionHeap.peek(), 10);
+}
+
+TEST(MinHeapTest, poll_keeps_last_item) {
+  MinHeap<std::string> minHeap;
+
+  minHeap.add(std::string("b"));
+  minHeap.emplace(3, 'a');
+
+  EXPECT_EQ(*minHeap.poll(), "aaa");
+
+  // The pointer to the last polled item must stay valid.
+  auto last = minHeap.poll();
+  EXPECT_NE(last, nullptr);
+  EXPECT_EQ(*last, "b");
+  EXPECT_TRUE(minHeap.isEmpty());
+}
+
+TEST(MinHeapTest, peek_does_not_allocate) {
+  MinHeap<int> minHeap;
+
+  minHeap.add(3).add(1).add(2);
+
+  EXPECT_NO_ALLOC(EXPECT_EQ(*minHeap.peek(), 1));
+  EXPECT_NO_ALLOC(EXPECT_FALSE(minHeap.isEmpty()));
+}
+
+namespace MinHeapTest {
+// Orders strings by length and counts how often a key is extracted.
+struct CountingLength {
+  std::size_t operator()(const std::string &value) const {
+    ++*calls_;
+    return value.size();
+  }
+
+  int *calls_;
+};
+}  // namespace MinHeapTest
+
+TEST(MinHeapTest, projection_caches_keys) {
+  int calls = 0;
+  using compare_t =
+      ProjectionCompare<std::string, MinHeapTest::CountingLength>;
+  MinHeap<std::string, compare_t> minHeap(
+      compare_t(MinHeapTest::CountingLength{&calls}));
+
+  minHeap.add("ccc").add("a").add("dddd").add("bb").add("eeeee");
+  EXPECT_EQ(calls, 5);
+  EXPECT_EQ(minHeap.toString(), "a,bb,dddd,ccc,eeeee");
+
+  // Looking up an item projects it once.
+  EXPECT_EQ(minHeap.find("xx"), std::vector<int>({1}));
+  EXPECT_EQ(calls, 6);
+
+  minHeap.remove("yyy");
+  EXPECT_EQ(calls, 7);
+  EXPECT_EQ(*minHeap.poll(), "a");
+  EXPECT_EQ(*minHeap.poll(), "bb");
+  EXPECT_EQ(*minHeap.poll(), "dddd");
+  EXPECT_EQ(*minHeap.poll(), "eeeee");
+  EXPECT_TRUE(minHeap.isEmpty());
+  EXPECT_EQ(calls, 7);
+}
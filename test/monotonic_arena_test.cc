@@ -0,0 +1,145 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "monotonic_arena.hpp"
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "hash_table.hpp"
+#include "linked_list.hpp"
+#include "min_heap.hpp"
+#include "priority_queue.hpp"
+#include "queue.hpp"
+#include "red_black_tree.hpp"
+#include "stack.hpp"
+
+TEST(MonotonicArenaTest, allocate) {
+  MonotonicArena arena(64);
+
+  auto a = arena.allocate(1, 1);
+  auto b = arena.allocate(8, 8);
+  auto c = arena.allocate(256, 16);
+
+  EXPECT_NE(a, nullptr);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 16, 0);
+  EXPECT_EQ(arena.bytesAllocated(), 265);
+
+  arena.release();
+
+  EXPECT_EQ(arena.bytesAllocated(), 0);
+  EXPECT_NE(arena.allocate(8, 8), nullptr);
+}
+
+TEST(MonotonicArenaTest, default_allocator) {
+  ArenaAllocator<int> allocator;
+  auto p = allocator.allocate(4);
+  p[3] = 1;
+  allocator.deallocate(p, 4);
+
+  EXPECT_EQ(allocator.arena(), nullptr);
+  EXPECT_TRUE(allocator == ArenaAllocator<char>());
+}
+
+TEST(MonotonicArenaTest, linked_list) {
+  MonotonicArena arena;
+  ArenaAllocator<int> allocator(&arena);
+
+  {
+    LinkedList<int, DefaultCompare<int>, NoStats, ArenaAllocator<int>> list(
+        DefaultCompare<int>(), allocator);
+    list.append(1).append(2).prepend(0);
+
+    EXPECT_EQ(list.toString(), "0,1,2");
+    EXPECT_GT(arena.bytesAllocated(), 0);
+
+    Queue<int, NoStats, ArenaAllocator<int>> queue(allocator);
+    queue.enqueue(1);
+    queue.enqueue(2);
+    EXPECT_EQ(queue.dequeue(), 1);
+
+    Stack<int, NoStats, ArenaAllocator<int>> stack(allocator);
+    stack.push(1);
+    stack.push(2);
+    EXPECT_EQ(stack.pop(), 2);
+  }
+
+  arena.release();
+}
+
+TEST(MonotonicArenaTest, hash_table) {
+  MonotonicArena arena;
+  ArenaAllocator<std::string> allocator(&arena);
+
+  {
+    HashTable<std::string, 4, NoStats, ArenaAllocator<std::string>> hashTable(
+        allocator);
+    hashTable.set("a", "sky");
+    hashTable.set("b", "sea");
+
+    EXPECT_EQ(*hashTable.get("a"), "sky");
+    EXPECT_EQ(*hashTable.get("b"), "sea");
+    EXPECT_GT(arena.bytesAllocated(), 0);
+  }
+
+  arena.release();
+}
+
+TEST(MonotonicArenaTest, heaps) {
+  MonotonicArena arena;
+  ArenaAllocator<int> allocator(&arena);
+
+  {
+    MinHeap<int, DefaultCompare<int>, NoStats, ArenaAllocator<int>> minHeap(
+        DefaultCompare<int>(), allocator);
+    minHeap.add(3).add(1).add(2);
+
+    EXPECT_EQ(*minHeap.poll(), 1);
+    EXPECT_GT(arena.bytesAllocated(), 0);
+
+    PriorityQueue<int, NoStats, ArenaAllocator<int>> priorityQueue(allocator);
+    priorityQueue.add(10, 1);
+    priorityQueue.add(5, 0);
+
+    EXPECT_EQ(*priorityQueue.poll(), 5);
+  }
+
+  arena.release();
+}
+
+TEST(MonotonicArenaTest, trees) {
+  MonotonicArena arena;
+  ArenaAllocator<int> allocator(&arena);
+
+  {
+    RedBlackTree<int, DefaultCompare<int>, NoStats, ArenaAllocator<int>> tree(
+        DefaultCompare<int>(), allocator);
+    tree.insert(1);
+    tree.insert(2);
+    tree.insert(3);
+
+    EXPECT_EQ(tree.toString(), "1,2,3");
+    EXPECT_EQ(tree.root_->value_, 2);
+    EXPECT_GT(arena.bytesAllocated(), 0);
+  }
+
+  arena.release();
+}
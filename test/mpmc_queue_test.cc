@@ -0,0 +1,164 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mpmc_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+TEST(MpmcQueueTest, enqueue_dequeue) {
+  MpmcQueue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 4u);
+  EXPECT_TRUE(queue.isEmpty());
+
+  int value = -1;
+  EXPECT_FALSE(queue.tryDequeue(value));
+  EXPECT_EQ(value, -1);
+
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.tryEnqueue(i));
+  EXPECT_FALSE(queue.tryEnqueue(4));
+  EXPECT_EQ(queue.size(), 4u);
+
+  EXPECT_TRUE(queue.tryDequeue(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(queue.tryEnqueue(4));
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_TRUE(queue.tryDequeue(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MpmcQueueTest, move_only_values) {
+  MpmcQueue<std::unique_ptr<std::string>> queue(2);
+  std::unique_ptr<std::string> value;
+
+  EXPECT_TRUE(queue.tryEmplace(new std::string("a")));
+  EXPECT_TRUE(queue.tryEnqueue(
+      std::unique_ptr<std::string>(new std::string("b"))));
+  EXPECT_TRUE(queue.tryDequeue(value));
+  EXPECT_EQ(*value, "a");
+
+  // Values left behind are destroyed with the queue.
+  EXPECT_TRUE(queue.tryEmplace(new std::string("c")));
+}
+
+TEST(MpmcQueueTest, bulk) {
+  MpmcQueue<int> queue(8);
+  std::vector<int> values = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<int> out(10, -1);
+
+  EXPECT_EQ(queue.tryEnqueueBulk(values.data(), 5), 5u);
+  EXPECT_EQ(queue.tryDequeueBulk(out.data(), 3), 3u);
+  EXPECT_EQ(out[2], 2);
+
+  // Wraps around the end of the ring and stops when it is full.
+  EXPECT_EQ(queue.tryEnqueueBulk(values.data() + 5, 5), 5u);
+  EXPECT_EQ(queue.tryEnqueueBulk(values.data(), 10), 1u);
+  EXPECT_EQ(queue.tryEnqueueBulk(values.data(), 10), 0u);
+
+  EXPECT_EQ(queue.tryDequeueBulk(out.data(), 10), 8u);
+  EXPECT_EQ(out[0], 3);
+  EXPECT_EQ(out[6], 9);
+  EXPECT_EQ(out[7], 0);
+  EXPECT_EQ(queue.tryDequeueBulk(out.data(), 10), 0u);
+}
+
+TEST(MpmcQueueTest, does_not_allocate) {
+  MpmcQueue<std::string> queue(16);
+  std::string value;
+
+  EXPECT_NO_ALLOC(for (int i = 0; i < 1000; ++i) {
+    queue.tryEmplace(8, 'a');
+    queue.tryEmplace(8, 'b');
+    queue.tryDequeue(value);
+    queue.tryDequeue(value);
+  });
+}
+
+TEST(MpmcQueueTest, producers_and_consumers) {
+  const int threadCount = 4;
+  const int perProducer = 20000;
+  MpmcQueue<int> queue(64);
+  std::atomic<int> received(0);
+  std::atomic<long long> sum(0);
+  std::atomic<int> outOfOrder(0);
+  std::vector<std::thread> threads;
+
+  // Values are producer + threadCount * sequence.
+  for (int p = 0; p < threadCount; ++p) {
+    threads.emplace_back([&queue, p]() {
+      int batch[4];
+      for (int i = 0; i < perProducer;) {
+        std::size_t enqueued;
+        if (i % 2) {
+          enqueued = queue.tryEnqueue(p + threadCount * i);
+        } else {
+          int size = std::min(4, perProducer - i);
+          for (int j = 0; j < size; ++j) batch[j] = p + threadCount * (i + j);
+          enqueued = queue.tryEnqueueBulk(batch, size);
+        }
+
+        i += static_cast<int>(enqueued);
+        if (!enqueued) std::this_thread::yield();
+      }
+    });
+  }
+
+  for (int c = 0; c < threadCount; ++c) {
+    threads.emplace_back([&, c]() {
+      // Values of one producer reach one consumer in order.
+      std::vector<int> last(threadCount, -1);
+      auto take = [&](int value) {
+        if (value <= last[value % threadCount]) ++outOfOrder;
+        last[value % threadCount] = value;
+        sum += value;
+        ++received;
+      };
+
+      int batch[3];
+      while (received < threadCount * perProducer) {
+        int value;
+        if (c % 2 && queue.tryDequeue(value)) {
+          take(value);
+        } else if (auto size = queue.tryDequeueBulk(batch, 3)) {
+          for (std::size_t j = 0; j < size; ++j) take(batch[j]);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) thread.join();
+
+  long long total = static_cast<long long>(threadCount) * perProducer;
+  EXPECT_EQ(received, total);
+  EXPECT_EQ(sum, total * (total - 1) / 2);
+  EXPECT_EQ(outOfOrder, 0);
+  EXPECT_TRUE(queue.isEmpty());
+}
@@ -0,0 +1,160 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "node_pool.hpp"
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "linked_list.hpp"
+#include "queue.hpp"
+#include "red_black_tree.hpp"
+#include "stack.hpp"
+#include "test/allocation_counter.hpp"
+
+TEST(NodePoolTest, allocate) {
+  NodePool pool(1024);
+
+  auto a = pool.allocate(1);
+  auto b = pool.allocate(24);
+  auto c = pool.allocate(NodePool::MAX_BLOCK_SIZE);
+
+  EXPECT_NE(a, nullptr);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % NodePool::BLOCK_ALIGNMENT,
+            0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % NodePool::BLOCK_ALIGNMENT,
+            0);
+  EXPECT_EQ(pool.blocksInUse(), 3);
+  EXPECT_EQ(pool.chunkCount(), 1);
+
+  pool.release();
+
+  EXPECT_EQ(pool.blocksInUse(), 0);
+  EXPECT_EQ(pool.chunkCount(), 0);
+}
+
+TEST(NodePoolTest, recycle_freed_blocks) {
+  NodePool pool;
+
+  auto a = pool.allocate(40);
+  auto b = pool.allocate(40);
+  pool.deallocate(a, 40);
+  pool.deallocate(b, 40);
+
+  // Freed blocks are handed out again, last freed first, and only to
+  // requests of the same size class.
+  EXPECT_NE(pool.allocate(16), b);
+  EXPECT_EQ(pool.allocate(48), b);
+  EXPECT_EQ(pool.allocate(33), a);
+  EXPECT_EQ(pool.blocksInUse(), 3);
+}
+
+TEST(NodePoolTest, grow_in_chunks) {
+  NodePool pool(1024);
+
+  for (int i = 0; i < 1024 / 64; ++i) {
+    pool.allocate(64);
+  }
+  EXPECT_EQ(pool.chunkCount(), 1);
+
+  pool.allocate(64);
+  EXPECT_EQ(pool.chunkCount(), 2);
+}
+
+TEST(NodePoolTest, default_allocator) {
+  PoolAllocator<int> allocator;
+  auto p = allocator.allocate(4);
+  p[3] = 1;
+  allocator.deallocate(p, 4);
+
+  EXPECT_EQ(allocator.pool(), nullptr);
+  EXPECT_TRUE(allocator == PoolAllocator<char>());
+}
+
+TEST(NodePoolTest, arrays_use_heap) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+
+  auto p = allocator.allocate(4);
+  EXPECT_EQ(pool.blocksInUse(), 0);
+  allocator.deallocate(p, 4);
+
+  p = allocator.allocate(1);
+  EXPECT_EQ(pool.blocksInUse(), 1);
+  allocator.deallocate(p, 1);
+  EXPECT_EQ(pool.blocksInUse(), 0);
+}
+
+TEST(NodePoolTest, linked_list) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+
+  {
+    LinkedList<int, DefaultCompare<int>, NoStats, PoolAllocator<int>> list(
+        DefaultCompare<int>(), allocator);
+    list.append(1).append(2).prepend(0);
+
+    EXPECT_EQ(list.toString(), "0,1,2");
+    EXPECT_EQ(pool.blocksInUse(), 3);
+
+    list.deleteHead();
+    EXPECT_EQ(pool.blocksInUse(), 2);
+  }
+
+  EXPECT_EQ(pool.blocksInUse(), 0);
+}
+
+TEST(NodePoolTest, queue_churn_does_not_allocate) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  Queue<int, NoStats, PoolAllocator<int>> queue(allocator);
+  Stack<int, NoStats, PoolAllocator<int>> stack(allocator);
+
+  queue.enqueue(0);
+  stack.push(0);
+  EXPECT_NO_ALLOC(for (int i = 1; i < 1000; ++i) {
+    queue.enqueue(i);
+    EXPECT_EQ(queue.dequeue(), i - 1);
+    stack.push(i);
+    EXPECT_EQ(stack.pop(), i);
+  });
+  // The queue keeps its values in one buffer, which is not pooled.
+  EXPECT_EQ(pool.blocksInUse(), 1);
+}
+
+TEST(NodePoolTest, large_nodes_use_heap) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+
+  {
+    RedBlackTree<int, DefaultCompare<int>, NoStats, PoolAllocator<int>> tree(
+        DefaultCompare<int>(), allocator);
+    tree.insert(1);
+    tree.insert(2);
+    tree.insert(3);
+
+    EXPECT_EQ(tree.toString(), "1,2,3");
+    EXPECT_EQ(tree.root_->value_, 2);
+
+    // Tree nodes carry a meta hash table and are too large for the pool.
+    EXPECT_EQ(pool.blocksInUse(), 0);
+  }
+}
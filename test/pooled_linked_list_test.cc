@@ -0,0 +1,192 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "pooled_linked_list.hpp"
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+TEST(PooledLinkedListTest, create_empty) {
+  PooledLinkedList<int> list;
+
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.size(), 0);
+  EXPECT_EQ(list.head(), nullptr);
+  EXPECT_EQ(list.tail(), nullptr);
+  EXPECT_EQ(list.toString(), "");
+}
+
+TEST(PooledLinkedListTest, append_and_prepend) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+
+  list.append(1).append(2).prepend(0).emplaceAppend(3);
+
+  EXPECT_EQ(list.size(), 4);
+  EXPECT_EQ(*list.head(), 0);
+  EXPECT_EQ(*list.tail(), 3);
+  EXPECT_EQ(list.toString(), "0,1,2,3");
+  EXPECT_EQ(list.values(), std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(pool.blocksInUse(), 4);
+}
+
+TEST(PooledLinkedListTest, remove) {
+  PooledLinkedList<int, DefaultCompare<int>, OperationStats> list;
+
+  list.append(3).append(1).append(3).append(2).append(3);
+
+  EXPECT_EQ(list.remove(*list.find(3)), 3);
+  EXPECT_EQ(list.remove(5), 0);
+  EXPECT_EQ(list.toString(), "1,2");
+  EXPECT_EQ(*list.tail(), 2);
+
+  EXPECT_EQ(list.remove(2), 1);
+  EXPECT_EQ(*list.tail(), 1);
+  list.append(4);
+  EXPECT_EQ(list.toString(), "1,4");
+
+  EXPECT_EQ(list.remove(1) + list.remove(4), 2);
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.tail(), nullptr);
+}
+
+TEST(PooledLinkedListTest, find) {
+  PooledLinkedList<std::string, DefaultCompare<std::string>, OperationStats>
+      list;
+
+  EXPECT_EQ(list.find("a"), nullptr);
+
+  list.append("a").append("bb").append("ccc");
+
+  auto isLong = [](const std::string& value) { return value.size() == 3; };
+
+  EXPECT_EQ(*list.find("bb"), "bb");
+  EXPECT_EQ(*list.find(isLong), "ccc");
+  EXPECT_EQ(list.find(std::function<bool(const std::string&)>()), nullptr);
+  EXPECT_EQ(list.stats().node_visits_, 5);
+}
+
+TEST(PooledLinkedListTest, delete_head) {
+  PooledLinkedList<std::unique_ptr<std::string>> list;
+
+  EXPECT_FALSE(list.deleteHead());
+
+  list.emplaceAppend(new std::string("a"));
+  list.emplaceAppend(new std::string("b"));
+
+  std::unique_ptr<std::string> value;
+  EXPECT_TRUE(list.deleteHead(&value));
+  EXPECT_EQ(*value, "a");
+  EXPECT_TRUE(list.deleteHead());
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.tail(), nullptr);
+}
+
+TEST(PooledLinkedListTest, copy_and_move) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+  list.append(1).append(2);
+
+  PooledLinkedList<int> copy(list);
+  copy.append(3);
+  EXPECT_EQ(list.toString(), "1,2");
+  EXPECT_EQ(copy.toString(), "1,2,3");
+  EXPECT_EQ(pool.blocksInUse(), 5);
+
+  PooledLinkedList<int> moved(std::move(copy));
+  EXPECT_TRUE(copy.isEmpty());
+  list = moved;
+  moved.deleteHead();
+  EXPECT_EQ(list.toString(), "1,2,3");
+  EXPECT_EQ(moved.toString(), "2,3");
+  EXPECT_EQ(pool.blocksInUse(), 5);
+}
+
+TEST(PooledLinkedListTest, iterate) {
+  PooledLinkedList<int> list;
+  list.append(1).append(2).append(3);
+
+  for (auto& value : list) {
+    value *= 10;
+  }
+
+  const auto& constList = list;
+  std::vector<int> values(constList.begin(), constList.end());
+  EXPECT_EQ(values, std::vector<int>({10, 20, 30}));
+}
+
+TEST(PooledLinkedListTest, snapshot) {
+  PooledLinkedList<std::string> source;
+  source.append("a").append("bb");
+
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  source.writeSnapshot(writer);
+  auto snapshot = ss.str();
+
+  PooledLinkedList<std::string> list;
+  list.append("x");
+  SnapshotReader truncated(snapshot.data(), snapshot.size() - 1);
+  EXPECT_THROW(list.readSnapshot(truncated), SnapshotError);
+  EXPECT_EQ(list.toString(), "x");
+
+  SnapshotReader reader(snapshot.data(), snapshot.size());
+  list.readSnapshot(reader);
+  EXPECT_EQ(list.toString(), "a,bb");
+  EXPECT_EQ(*list.tail(), "bb");
+}
+
+// Every node is a single pooled block, so a warmed up list churns without
+// touching the heap.
+TEST(PooledLinkedListTest, churn_does_not_allocate) {
+  NodePool pool;
+  PoolAllocator<int> allocator(&pool);
+  PooledLinkedList<int> list(DefaultCompare<int>(), allocator);
+
+  list.append(0);
+  list.append(1);
+  list.deleteHead();
+  EXPECT_NO_ALLOC(for (int i = 2; i < 1000; ++i) {
+    list.append(i);
+    EXPECT_TRUE(list.deleteHead());
+  });
+  EXPECT_EQ(*list.head(), 999);
+  EXPECT_EQ(pool.blocksInUse(), 1);
+}
+
+TEST(PooledLinkedListTest, clear_long_list) {
+  PooledLinkedList<int> list;
+  for (int i = 0; i < 1000000; ++i) {
+    list.append(i);
+  }
+
+  list.clear();
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.head(), nullptr);
+}
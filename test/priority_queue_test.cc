@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "priority_queue.hpp"
+#include <utility>
 #include "gtest/gtest.h"
 
 TEST(PriorityQueueTest, create_empty) {
@@ -123,3 +124,41 @@ TEST(PriorityQueueTest, search_by_value) {
   EXPECT_FALSE(priorityQueue.hasValue(70));
   EXPECT_TRUE(priorityQueue.hasValue(15));
 }
+
+TEST(PriorityQueueTest, copy_keeps_own_priorities) {
+  PriorityQueue<int> priorityQueue;
+
+  priorityQueue.add(10, 1);
+  priorityQueue.add(5, 2);
+
+  PriorityQueue<int> copy(priorityQueue);
+  copy.changePriority(5, 0);
+  copy.add(20, 3);
+  priorityQueue.add(30, 0);
+
+  EXPECT_EQ(*copy.poll(), 5);
+  EXPECT_EQ(*copy.poll(), 10);
+  EXPECT_EQ(*copy.poll(), 20);
+  EXPECT_EQ(*priorityQueue.poll(), 30);
+  EXPECT_EQ(*priorityQueue.poll(), 10);
+  EXPECT_EQ(*priorityQueue.poll(), 5);
+}
+
+TEST(PriorityQueueTest, move_keeps_priorities) {
+  PriorityQueue<int> priorityQueue;
+
+  priorityQueue.add(10, 1);
+  priorityQueue.add(5, 2);
+
+  PriorityQueue<int> moved(std::move(priorityQueue));
+  moved.add(20, 0);
+
+  PriorityQueue<int> assigned;
+  assigned = std::move(moved);
+  assigned.add(30, 3);
+
+  EXPECT_EQ(*assigned.poll(), 20);
+  EXPECT_EQ(*assigned.poll(), 10);
+  EXPECT_EQ(*assigned.poll(), 5);
+  EXPECT_EQ(*assigned.poll(), 30);
+}
@@ -21,7 +21,12 @@
 // SOFTWARE.
 
 #include "queue.hpp"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 #include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
 
 TEST(QueueTest, create_empty) {
   Queue<int> queue;
@@ -87,3 +92,135 @@ TEST(QueueTest, dequeue) {
   // EXPECT_EQ(queue.dequeue(), nullptr);
   EXPECT_TRUE(queue.isEmpty());
 }
+
+TEST(QueueTest, enqueue_dequeue_move_only) {
+  Queue<std::unique_ptr<std::string>> queue;
+
+  queue.enqueue(std::unique_ptr<std::string>(new std::string("a")));
+  queue.emplace(new std::string("b"));
+
+  EXPECT_EQ(*queue.dequeue(), "a");
+  EXPECT_EQ(*queue.dequeue(), "b");
+  EXPECT_EQ(queue.dequeue(), nullptr);
+}
+
+TEST(QueueTest, clear_long_queue) {
+  Queue<int> queue;
+  for (int i = 0; i < 1000000; ++i) {
+    queue.enqueue(i);
+  }
+
+  queue.clear();
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_EQ(queue.peek(), nullptr);
+
+  for (int i = 0; i < 1000000; ++i) {
+    queue.enqueue(i);
+  }
+  EXPECT_EQ(queue.dequeue(), 0);
+}
+
+TEST(QueueTest, try_dequeue) {
+  Queue<std::unique_ptr<std::string>> queue;
+  std::unique_ptr<std::string> value(new std::string("untouched"));
+
+  EXPECT_FALSE(queue.tryDequeue(value));
+  EXPECT_EQ(*value, "untouched");
+
+  queue.emplace(new std::string("a"));
+  EXPECT_TRUE(queue.tryDequeue(value));
+  EXPECT_EQ(*value, "a");
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(QueueTest, grow_while_wrapped) {
+  Queue<int> queue;
+
+  // Moves the head away from the start of the buffer.
+  for (int i = 0; i < 10; ++i) queue.enqueue(i);
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(queue.dequeue(), i);
+  for (int i = 10; i < 24; ++i) queue.enqueue(i);
+  EXPECT_EQ(queue.capacity(), Queue<int>::MIN_CAPACITY);
+
+  queue.enqueue(24);
+  EXPECT_EQ(queue.capacity(), 2 * Queue<int>::MIN_CAPACITY);
+  EXPECT_EQ(queue.size(), 17u);
+  for (int i = 8; i <= 24; ++i) EXPECT_EQ(queue.dequeue(), i);
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(QueueTest, enqueue_own_value_while_growing) {
+  Queue<std::string> queue;
+  for (std::size_t i = 0; i < Queue<std::string>::MIN_CAPACITY; ++i) {
+    queue.enqueue(std::to_string(i));
+  }
+
+  queue.enqueue(*queue.peek());
+  EXPECT_EQ(queue.size(), Queue<std::string>::MIN_CAPACITY + 1);
+  EXPECT_EQ(queue.toString().substr(0, 4), "0,1,");
+  EXPECT_EQ(queue.toString().substr(queue.toString().size() - 4), "15,0");
+}
+
+TEST(QueueTest, bulk) {
+  Queue<int> queue;
+  std::vector<int> values;
+  for (int i = 0; i < 40; ++i) values.push_back(i);
+
+  queue.enqueue(-1);
+  queue.dequeue();
+  queue.enqueueBulk(values.data(), 20);
+  queue.enqueueBulk(values.data() + 20, 20);
+  EXPECT_EQ(queue.size(), 40u);
+  EXPECT_EQ(queue.capacity(), 64u);
+
+  std::vector<int> out(50, 0);
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 15), 15u);
+  EXPECT_EQ(out[14], 14);
+
+  // Wrap the values around the end of the buffer.
+  queue.enqueueBulk(values.data(), 30);
+  EXPECT_EQ(queue.capacity(), 64u);
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 50), 50u);
+  EXPECT_EQ(out[0], 15);
+  EXPECT_EQ(out[24], 39);
+  EXPECT_EQ(out[25], 0);
+  EXPECT_EQ(out[49], 24);
+
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 50), 5u);
+  EXPECT_EQ(out[4], 29);
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 50), 0u);
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(QueueTest, steady_state_does_not_allocate) {
+  Queue<std::string> queue;
+  queue.reserve(64);
+  for (int i = 0; i < 32; ++i) queue.emplace(4, 'a');
+  std::string value;
+
+  EXPECT_NO_ALLOC(for (int i = 0; i < 1000; ++i) {
+    queue.emplace(4, 'b');
+    queue.tryDequeue(value);
+  });
+  EXPECT_EQ(queue.capacity(), 64u);
+}
+
+TEST(QueueTest, copy_and_move) {
+  Queue<std::string> queue;
+  for (int i = 0; i < 20; ++i) queue.enqueue(std::to_string(i));
+  for (int i = 0; i < 10; ++i) queue.dequeue();
+
+  Queue<std::string> copy(queue);
+  EXPECT_EQ(copy.toString(), queue.toString());
+  EXPECT_EQ(copy.dequeue(), "10");
+  EXPECT_EQ(*queue.peek(), "10");
+
+  Queue<std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.isEmpty());
+  EXPECT_EQ(moved.size(), 9u);
+
+  copy = moved;
+  moved = Queue<std::string>();
+  EXPECT_EQ(copy.dequeue(), "11");
+  EXPECT_TRUE(moved.isEmpty());
+}
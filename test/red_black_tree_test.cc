@@ -21,6 +21,10 @@
 // SOFTWARE.
 
 #include "red_black_tree.hpp"
+#include <cstdint>
+#include <set>
+#include <string>
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(RedBlackTreeTest, color_first_node_black) {
@@ -334,9 +338,69 @@ TEST(RedBlackTreeTest, right_right_rotation_with_left_grandparent) {
   EXPECT_EQ(tree.root_->height(), 2);
 }
 
+namespace {
+
+// Checks that every child of node points back at it, and appends the values
+// below node in order.
+template <typename Node>
+void checkLinks(const std::shared_ptr<Node>& node, std::string* values) {
+  if (node->left_) {
+    EXPECT_EQ(node->left_->parent_.lock(), node);
+    checkLinks(node->left_, values);
+  }
+
+  *values += (values->empty() ? "" : ",") + std::to_string(node->value_);
+
+  if (node->right_) {
+    EXPECT_EQ(node->right_->parent_.lock(), node);
+    checkLinks(node->right_, values);
+  }
+}
+
+}  // namespace
+
+// Rotations used to clear the parent link of a node they had just
+// re-attached, which crashed later inserts.
+TEST(RedBlackTreeTest, insert_random_sequence) {
+  RedBlackTree<int> tree;
+  std::set<int> expected;
+  std::uint32_t seed = 12345;
+
+  for (int i = 0; i < 200; ++i) {
+    seed = seed * 1103515245u + 12345u;
+    int value = (seed >> 16) % 1000;
+    if (expected.insert(value).second) {
+      tree.insert(value);
+    }
+  }
+
+  std::string expectedValues;
+  for (auto value : expected) {
+    expectedValues += (expectedValues.empty() ? "" : ",") +
+                      std::to_string(value);
+  }
+
+  std::string values;
+  EXPECT_FALSE(tree.root_->parent_.lock());
+  checkLinks(tree.root_, &values);
+  EXPECT_EQ(values, expectedValues);
+  EXPECT_EQ(tree.toString(), expectedValues);
+}
+
 TEST(RedBlackTreeTest, remove) {
   auto tree = RedBlackTree<int>();
 
   EXPECT_THROW(tree.remove(1),
                RedBlackTree<int>::MethodNotImplementedException);
 }
+
+TEST(RedBlackTreeTest, contains_does_not_allocate) {
+  RedBlackTree<int> tree;
+
+  for (int value = 0; value < 32; ++value) {
+    tree.insert(value);
+  }
+
+  EXPECT_NO_ALLOC(EXPECT_TRUE(tree.contains(17)));
+  EXPECT_NO_ALLOC(EXPECT_FALSE(tree.contains(32)));
+}
@@ -0,0 +1,162 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "skip_list.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "node_pool.hpp"
+#include "stats.hpp"
+#include "test/allocation_counter.hpp"
+
+TEST(SkipListTest, insert_find_remove) {
+  SkipList<int> list;
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.head(), nullptr);
+  EXPECT_EQ(list.find(1), nullptr);
+  EXPECT_FALSE(list.remove(1));
+
+  EXPECT_TRUE(list.insert(3));
+  EXPECT_TRUE(list.insert(1));
+  EXPECT_TRUE(list.insert(2));
+  EXPECT_FALSE(list.insert(2));
+  EXPECT_EQ(list.size(), 3u);
+  EXPECT_EQ(list.toString(), "1,2,3");
+  EXPECT_EQ(*list.head(), 1);
+
+  EXPECT_EQ(*list.find(2), 2);
+  EXPECT_TRUE(list.contains(3));
+  EXPECT_FALSE(list.contains(4));
+
+  EXPECT_TRUE(list.remove(2));
+  EXPECT_FALSE(list.remove(2));
+  EXPECT_EQ(list.toString(), "1,3");
+  EXPECT_TRUE(list.remove(1));
+  EXPECT_TRUE(list.remove(3));
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.height(), 1u);
+}
+
+TEST(SkipListTest, lower_bound_and_scan) {
+  SkipList<int> list;
+  for (int i = 0; i < 100; i += 10) list.insert(i);
+
+  EXPECT_EQ(*list.lowerBound(-5), 0);
+  EXPECT_EQ(*list.lowerBound(30), 30);
+  EXPECT_EQ(*list.lowerBound(31), 40);
+  EXPECT_TRUE(list.lowerBound(91) == list.end());
+
+  std::vector<int> values;
+  auto collect = [&](int value) { values.push_back(value); };
+  EXPECT_EQ(list.scan(15, 50, collect), 3u);
+  EXPECT_EQ(values, std::vector<int>({20, 30, 40}));
+
+  EXPECT_EQ(list.scan(50, 50, collect), 0u);
+  EXPECT_EQ(list.scan(95, 200, collect), 0u);
+}
+
+TEST(SkipListTest, matches_std_set) {
+  SkipList<int, DefaultCompare<int>, OperationStats> list;
+  std::set<int> expected;
+  std::mt19937 generator(3);
+  std::uniform_int_distribution<int> key(0, 999);
+
+  for (int i = 0; i < 20000; ++i) {
+    auto value = key(generator);
+    if (i % 3 == 2) {
+      EXPECT_EQ(list.remove(value), expected.erase(value) == 1);
+    } else {
+      EXPECT_EQ(list.insert(value), expected.insert(value).second);
+    }
+  }
+
+  EXPECT_EQ(list.size(), expected.size());
+  EXPECT_EQ(list.toArray(),
+            std::vector<int>(expected.begin(), expected.end()));
+  EXPECT_GT(list.height(), 1u);
+
+  // Lookups skip most of the nodes.
+  auto visits = list.stats().node_visits_;
+  list.find(998);
+  EXPECT_LT(list.stats().node_visits_ - visits, 100u);
+}
+
+TEST(SkipListTest, custom_compare) {
+  SkipList<std::string, FunctionCompare<std::string>> list(
+      [](const std::string& a, const std::string& b) {
+        return b.compare(a);
+      });
+
+  list.insert("a");
+  list.insert("c");
+  list.insert(std::string("b"));
+  EXPECT_EQ(list.toString(), "c,b,a");
+  EXPECT_EQ(*list.lowerBound("bb"), "b");
+}
+
+TEST(SkipListTest, copy_move_swap) {
+  SkipList<int> list;
+  for (int i = 0; i < 1000; ++i) list.insert(i * 7 % 1000);
+
+  SkipList<int> copy(list);
+  EXPECT_EQ(copy.toArray(), list.toArray());
+  EXPECT_TRUE(copy.remove(500));
+  EXPECT_TRUE(copy.insert(1000));
+  EXPECT_TRUE(copy.contains(999));
+  EXPECT_TRUE(list.contains(500));
+
+  SkipList<int> moved(std::move(copy));
+  EXPECT_TRUE(copy.isEmpty());
+  EXPECT_EQ(moved.size(), 1000u);
+  EXPECT_TRUE(moved.contains(1000));
+
+  copy = list;
+  copy.swap(moved);
+  EXPECT_FALSE(moved.contains(1000));
+  EXPECT_TRUE(copy.contains(1000));
+
+  SkipList<int, DefaultCompare<int>, OperationStats> counted;
+  SkipList<int, DefaultCompare<int>, OperationStats> other;
+  counted.insert(1);
+  counted.insert(2);
+  counted.swap(other);
+  EXPECT_EQ(counted.stats().allocations_, 0u);
+  EXPECT_EQ(other.stats().allocations_, 2u);
+}
+
+TEST(SkipListTest, pooled_nodes) {
+  NodePool pool;
+  SkipList<int, DefaultCompare<int>, NoStats, PoolAllocator<int>> list{
+      DefaultCompare<int>(), PoolAllocator<int>(&pool)};
+
+  for (int i = 0; i < 1000; ++i) list.insert(i);
+  for (int i = 0; i < 1000; i += 2) list.remove(i);
+  EXPECT_EQ(list.size(), 500u);
+
+  // Freed nodes of the most common height are reused.
+  EXPECT_NO_ALLOC(list.insert(0));
+  list.clear();
+  EXPECT_EQ(pool.blocksInUse(), 0u);
+}
@@ -0,0 +1,111 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdio>
+#include <string>
+#include "hash_table.hpp"
+#include "red_black_tree.hpp"
+#include "snapshot_file.hpp"
+#include "snapshot_view.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+const char* SNAPSHOT_PATH = "snapshot_file_test.snapshot";
+
+}  // namespace
+
+TEST(SnapshotFileTest, save_and_load) {
+  RedBlackTree<int> tree;
+  for (int value = 0; value < 1000; value += 2) {
+    tree.insert(value);
+  }
+
+  saveSnapshot(tree, SNAPSHOT_PATH);
+
+  RedBlackTree<int> restored;
+  loadSnapshot(SNAPSHOT_PATH, &restored);
+  std::remove(SNAPSHOT_PATH);
+
+  EXPECT_EQ(restored.toString(), tree.toString());
+  EXPECT_THROW(loadSnapshot(SNAPSHOT_PATH, &restored), SnapshotError);
+}
+
+TEST(SnapshotFileTest, sorted_view) {
+  RedBlackTree<int> tree;
+  for (int value = 0; value < 1000; value += 2) {
+    tree.insert(value);
+  }
+
+  saveSnapshot(tree, SNAPSHOT_PATH);
+  MappedFile file(SNAPSHOT_PATH);
+  std::remove(SNAPSHOT_PATH);
+
+  SortedSnapshotView<int> view(file.data(), file.size());
+  EXPECT_EQ(view.size(), 500);
+  EXPECT_EQ(view.at(0), 0);
+  EXPECT_EQ(view.at(499), 998);
+  EXPECT_EQ(view.lowerBound(501), 251);
+  EXPECT_EQ(view.lowerBound(2000), 500);
+  EXPECT_TRUE(view.contains(500));
+  EXPECT_FALSE(view.contains(501));
+  EXPECT_FALSE(view.contains(-1));
+
+  EXPECT_THROW(SortedSnapshotView<double>(file.data(), file.size()),
+               SnapshotError);
+}
+
+TEST(SnapshotFileTest, hash_table_view) {
+  HashTable<int, 3> hashTable;
+  hashTable.set("a", 1);
+  hashTable.set("b", 2);
+  hashTable.set("c", 3);
+  hashTable.set("d", 4);
+
+  saveSnapshot(hashTable, SNAPSHOT_PATH);
+  MappedFile file(SNAPSHOT_PATH);
+  std::remove(SNAPSHOT_PATH);
+
+  HashTableSnapshotView<int, 3> view(file.data(), file.size());
+  int value = 0;
+  EXPECT_TRUE(view.get("d", &value));
+  EXPECT_EQ(value, 4);
+  EXPECT_TRUE(view.has("a"));
+  EXPECT_FALSE(view.has("x"));
+
+  // The view hashes like the table, so the bucket count must match.
+  typedef HashTableSnapshotView<int, 32> OtherView;
+  EXPECT_THROW(OtherView(file.data(), file.size()), SnapshotError);
+
+  HashTable<std::string> strings;
+  strings.set("key", "value");
+  saveSnapshot(strings, SNAPSHOT_PATH);
+  MappedFile stringsFile(SNAPSHOT_PATH);
+  std::remove(SNAPSHOT_PATH);
+
+  HashTableSnapshotView<std::string> stringsView(stringsFile.data(),
+                                                 stringsFile.size());
+  std::string text;
+  EXPECT_TRUE(stringsView.get("key", &text));
+  EXPECT_EQ(text, "value");
+  EXPECT_FALSE(stringsView.has("value"));
+}
@@ -0,0 +1,355 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "avl_tree.hpp"
+#include "deque.hpp"
+#include "hash_table.hpp"
+#include "linked_list.hpp"
+#include "min_heap.hpp"
+#include "priority_queue.hpp"
+#include "queue.hpp"
+#include "red_black_tree.hpp"
+#include "snapshot.hpp"
+#include "stack.hpp"
+#include "trie.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+template <typename Container>
+std::string takeSnapshot(const Container& container) {
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  container.writeSnapshot(writer);
+  return ss.str();
+}
+
+template <typename Container>
+void restoreSnapshot(const std::string& snapshot, Container* container) {
+  SnapshotReader reader(snapshot.data(), snapshot.size());
+  container->readSnapshot(reader);
+  EXPECT_EQ(reader.remaining(), 0);
+}
+
+// Returns the number of black nodes on every path from the node down, or -1
+// if the paths differ or a red node has a red child.
+template <typename Tree>
+int blackHeight(const Tree& tree,
+                const std::shared_ptr<BinaryTreeNode<int>>& node) {
+  if (!node) {
+    return 0;
+  }
+
+  if (tree.isNodeRed(*node) &&
+      ((node->left_ && tree.isNodeRed(*node->left_)) ||
+       (node->right_ && tree.isNodeRed(*node->right_)))) {
+    return -1;
+  }
+
+  auto left = blackHeight(tree, node->left_);
+  auto right = blackHeight(tree, node->right_);
+  if (left < 0 || left != right) {
+    return -1;
+  }
+
+  return left + (tree.isNodeBlack(*node) ? 1 : 0);
+}
+
+// Orders strings by length and refuses to project "!".
+struct CheckedLength {
+  std::size_t operator()(const std::string& value) const {
+    if (value == "!") {
+      throw std::invalid_argument("no key");
+    }
+
+    return value.size();
+  }
+};
+
+}  // namespace
+
+TEST(SnapshotTest, codec) {
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  writer.write(42);
+  writer.write(true);
+  writer.write(std::string("text"));
+  writer.write(std::make_pair(std::string("key"), 1.5));
+
+  auto bytes = ss.str();
+  EXPECT_EQ(bytes.size(), sizeof(int) + 1 + (4 + 4) + (4 + 3 + sizeof(double)));
+
+  SnapshotReader reader(bytes.data(), bytes.size());
+  EXPECT_EQ(reader.read<int>(), 42);
+  EXPECT_EQ(reader.read<bool>(), true);
+  EXPECT_EQ(reader.read<std::string>(), "text");
+  EXPECT_EQ((reader.read<std::pair<std::string, double>>()),
+            std::make_pair(std::string("key"), 1.5));
+  EXPECT_THROW(reader.read<char>(), SnapshotError);
+}
+
+TEST(SnapshotTest, linked_list_queue_stack) {
+  LinkedList<std::string> list;
+  list.append("a").append("bc").append("");
+
+  LinkedList<std::string> restoredList;
+  restoredList.append("old");
+  restoreSnapshot(takeSnapshot(list), &restoredList);
+  EXPECT_EQ(restoredList.toString(), "a,bc,");
+  EXPECT_EQ(restoredList.tail_->value_, "");
+
+  Queue<int> queue;
+  queue.enqueue(1);
+  queue.enqueue(2);
+
+  Queue<int> restoredQueue;
+  restoreSnapshot(takeSnapshot(queue), &restoredQueue);
+  EXPECT_EQ(restoredQueue.dequeue(), 1);
+  EXPECT_EQ(restoredQueue.dequeue(), 2);
+
+  Stack<int> restoredStack;
+  restoreSnapshot(takeSnapshot(queue), &restoredStack);
+  EXPECT_EQ(restoredStack.pop(), 2);
+
+  Deque<int> restoredDeque;
+  restoreSnapshot(takeSnapshot(queue), &restoredDeque);
+  EXPECT_EQ(restoredDeque.toString(), "1,2");
+  restoreSnapshot(takeSnapshot(restoredDeque), &restoredQueue);
+  EXPECT_EQ(restoredQueue.toString(), "1,2");
+
+  LinkedList<int> empty;
+  restoreSnapshot(takeSnapshot(LinkedList<int>()), &empty);
+  EXPECT_EQ(empty.head_, nullptr);
+  EXPECT_EQ(empty.tail_, nullptr);
+}
+
+TEST(SnapshotTest, hash_table) {
+  HashTable<std::string, 3> hashTable;
+  hashTable.set("a", "sky");
+  hashTable.set("b", "sea");
+  hashTable.set("c", "earth");
+  hashTable.set("d", "ocean");
+
+  HashTable<std::string, 3> restored;
+  restored.set("x", "old");
+  restoreSnapshot(takeSnapshot(hashTable), &restored);
+  EXPECT_EQ(restored.getKeys(),
+            std::unordered_set<std::string>({"a", "b", "c", "d"}));
+  EXPECT_EQ(*restored.get("d"), "ocean");
+
+  // A table with another bucket count rehashes the entries.
+  HashTable<std::string, 7> rehashed;
+  restoreSnapshot(takeSnapshot(hashTable), &rehashed);
+  EXPECT_EQ(*rehashed.get("a"), "sky");
+  EXPECT_EQ(*rehashed.get("c"), "earth");
+  EXPECT_FALSE(rehashed.has("x"));
+}
+
+TEST(SnapshotTest, min_heap_and_priority_queue) {
+  MinHeap<int> minHeap;
+  minHeap.add(5).add(3).add(10).add(1);
+
+  MinHeap<int> restoredHeap;
+  restoreSnapshot(takeSnapshot(minHeap), &restoredHeap);
+  EXPECT_EQ(restoredHeap.toString(), minHeap.toString());
+
+  // Loading into a max heap rebuilds the heap with its own comparator.
+  MinHeap<int, FunctionCompare<int>> maxHeap(
+      [](int a, int b) { return a == b ? 0 : (a > b ? -1 : 1); });
+  restoreSnapshot(takeSnapshot(minHeap), &maxHeap);
+  EXPECT_EQ(*maxHeap.poll(), 10);
+  EXPECT_EQ(*maxHeap.poll(), 5);
+
+  PriorityQueue<std::string> priorityQueue;
+  priorityQueue.add("low", 10).add("high", 1).add("middle", 5);
+
+  PriorityQueue<std::string> restoredQueue;
+  restoreSnapshot(takeSnapshot(priorityQueue), &restoredQueue);
+  EXPECT_EQ(*restoredQueue.poll(), "high");
+  EXPECT_EQ(*restoredQueue.poll(), "middle");
+  EXPECT_EQ(*restoredQueue.poll(), "low");
+}
+
+TEST(SnapshotTest, trees) {
+  BinarySearchTree<int> degenerate;
+  for (int value = 0; value < 100; ++value) {
+    degenerate.insert(value);
+  }
+
+  // The tree is rebuilt balanced from the sorted values.
+  BinarySearchTree<int> restored;
+  restoreSnapshot(takeSnapshot(degenerate), &restored);
+  EXPECT_EQ(restored.toString(), degenerate.toString());
+  EXPECT_EQ(restored.root_->height(), 6);
+  EXPECT_TRUE(restored.contains(42));
+
+  // Snapshots of all search trees are interchangeable.
+  AvlTree<int> avlTree;
+  restoreSnapshot(takeSnapshot(degenerate), &avlTree);
+  avlTree.insert(100);
+  EXPECT_LE(std::abs(avlTree.root_->balanceFactor()), 1);
+  EXPECT_EQ(avlTree.root_->height(), 6);
+
+  BinarySearchTree<int> empty;
+  restoreSnapshot(takeSnapshot(BinarySearchTree<int>()), &empty);
+  EXPECT_EQ(empty.toString(), "");
+  empty.insert(1);
+  EXPECT_EQ(empty.toString(), "1");
+}
+
+TEST(SnapshotTest, red_black_tree_colors) {
+  for (int size = 1; size <= 64; ++size) {
+    RedBlackTree<int> tree;
+    for (int value = 0; value < size; ++value) {
+      tree.insert(value);
+    }
+
+    RedBlackTree<int> restored;
+    restoreSnapshot(takeSnapshot(tree), &restored);
+    EXPECT_EQ(restored.toString(), tree.toString());
+    EXPECT_TRUE(restored.isNodeBlack(*restored.root_));
+    EXPECT_GT(blackHeight(restored, restored.root_), 0) << "size " << size;
+
+    // The tree stays usable after loading.
+    restored.insert(size);
+    EXPECT_GT(blackHeight(restored, restored.root_), 0) << "size " << size;
+  }
+}
+
+TEST(SnapshotTest, trie) {
+  Trie trie;
+  trie.addWord("cat");
+  trie.addWord("cats");
+  trie.addWord("car");
+  trie.addWord("dog");
+
+  Trie restored;
+  restoreSnapshot(takeSnapshot(trie), &restored);
+  EXPECT_TRUE(restored.doesWordExist("cats"));
+  EXPECT_TRUE(restored.doesWordExist("dog"));
+  EXPECT_FALSE(restored.doesWordExist("cow"));
+  EXPECT_EQ(restored.suggestNextCharacters("ca"),
+            std::unordered_set<std::string>({"t", "r"}));
+  EXPECT_EQ(restored.head_.getChild('c')->getChild('a')->getChild('t')
+                ->toString(),
+            "t*:s");
+}
+
+TEST(SnapshotTest, reject_malformed) {
+  LinkedList<int> list;
+  list.append(1).append(2);
+  auto snapshot = takeSnapshot(list);
+
+  // Wrong container, value type, magic and truncated payload.
+  MinHeap<int> minHeap;
+  EXPECT_THROW(restoreSnapshot(snapshot, &minHeap), SnapshotError);
+  LinkedList<double> doubles;
+  EXPECT_THROW(restoreSnapshot(snapshot, &doubles), SnapshotError);
+  LinkedList<int> restored;
+  EXPECT_THROW(restoreSnapshot("XXXX" + snapshot.substr(4), &restored),
+               SnapshotError);
+  EXPECT_THROW(restoreSnapshot(snapshot.substr(0, snapshot.size() - 1),
+                               &restored),
+               SnapshotError);
+
+  // A tree snapshot must be sorted, the tree is kept as it was.
+  std::stringstream ss;
+  SnapshotWriter writer(ss);
+  writer.writeHeader(SnapshotKind::SORTED, sizeof(int));
+  writer.write(std::uint64_t(3));
+  writer.write(1);
+  writer.write(3);
+  writer.write(2);
+
+  BinarySearchTree<int> tree;
+  tree.insert(7);
+  EXPECT_THROW(restoreSnapshot(ss.str(), &tree), SnapshotError);
+  EXPECT_EQ(tree.toString(), "7");
+}
+
+TEST(SnapshotTest, truncated_min_heap_is_kept) {
+  MinHeap<std::string> source;
+  source.add("x").add("yy").add("zzz");
+  auto snapshot = takeSnapshot(source);
+
+  // Cut off in the middle of the last string.
+  MinHeap<std::string> minHeap;
+  minHeap.add("b").add("a").add("c");
+  EXPECT_THROW(
+      restoreSnapshot(snapshot.substr(0, snapshot.size() - 2), &minHeap),
+      SnapshotError);
+
+  EXPECT_EQ(minHeap.toString(), "a,b,c");
+  minHeap.add("0");
+  EXPECT_EQ(*minHeap.poll(), "0");
+  EXPECT_EQ(*minHeap.poll(), "a");
+  EXPECT_EQ(*minHeap.poll(), "b");
+  EXPECT_EQ(*minHeap.poll(), "c");
+}
+
+// The cached keys are rebuilt before anything is swapped in, so a failed
+// read or projection keeps them in step with the items.
+TEST(SnapshotTest, failed_min_heap_read_keeps_cached_keys) {
+  using compare_t = ProjectionCompare<std::string, CheckedLength>;
+  MinHeap<std::string> source;
+  source.add("x").add("yy").add("zzz");
+  auto truncated = takeSnapshot(source);
+  truncated.resize(truncated.size() - 2);
+  source.add("!");
+  auto unprojectable = takeSnapshot(source);
+
+  MinHeap<std::string, compare_t> minHeap;
+  minHeap.add("ccc").add("a");
+  EXPECT_THROW(restoreSnapshot(truncated, &minHeap), SnapshotError);
+  EXPECT_THROW(restoreSnapshot(unprojectable, &minHeap),
+               std::invalid_argument);
+
+  minHeap.add("bb").add("dddd");
+  EXPECT_EQ(*minHeap.poll(), "a");
+  EXPECT_EQ(*minHeap.poll(), "bb");
+  EXPECT_EQ(*minHeap.poll(), "ccc");
+  EXPECT_EQ(*minHeap.poll(), "dddd");
+  EXPECT_TRUE(minHeap.isEmpty());
+}
+
+TEST(SnapshotTest, truncated_priority_queue_is_kept) {
+  PriorityQueue<std::string> source;
+  source.add("x", 3).add("yy", 2).add("zzz", 1);
+  auto snapshot = takeSnapshot(source);
+
+  // Cut off in the middle of the last heap item, after the priorities.
+  PriorityQueue<std::string> priorityQueue;
+  priorityQueue.add("b", 2).add("a", 1);
+  EXPECT_THROW(
+      restoreSnapshot(snapshot.substr(0, snapshot.size() - 2), &priorityQueue),
+      SnapshotError);
+
+  priorityQueue.add("c", 0);
+  EXPECT_EQ(*priorityQueue.poll(), "c");
+  EXPECT_EQ(*priorityQueue.poll(), "a");
+  EXPECT_EQ(*priorityQueue.poll(), "b");
+  EXPECT_TRUE(priorityQueue.isEmpty());
+}
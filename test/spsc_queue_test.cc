@@ -0,0 +1,137 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spsc_queue.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/allocation_counter.hpp"
+
+TEST(SpscQueueTest, enqueue_dequeue) {
+  SpscQueue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 4u);
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_EQ(queue.peek(), nullptr);
+
+  int value = -1;
+  EXPECT_FALSE(queue.tryDequeue(value));
+  EXPECT_EQ(value, -1);
+
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.enqueue(i));
+  EXPECT_FALSE(queue.enqueue(4));
+  EXPECT_EQ(queue.size(), 4u);
+  EXPECT_EQ(*queue.peek(), 0);
+
+  EXPECT_EQ(queue.dequeue(), 0);
+  EXPECT_TRUE(queue.enqueue(4));
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_TRUE(queue.tryDequeue(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_EQ(queue.dequeue(), 0);
+}
+
+TEST(SpscQueueTest, move_only_values) {
+  SpscQueue<std::unique_ptr<std::string>> queue(2);
+
+  EXPECT_TRUE(queue.emplace(new std::string("a")));
+  EXPECT_TRUE(queue.enqueue(
+      std::unique_ptr<std::string>(new std::string("b"))));
+  EXPECT_EQ(**queue.peek(), "a");
+  EXPECT_EQ(*queue.dequeue(), "a");
+
+  // Values left behind are destroyed with the queue.
+  EXPECT_TRUE(queue.emplace(new std::string("c")));
+}
+
+TEST(SpscQueueTest, bulk) {
+  SpscQueue<int> queue(8);
+  std::vector<int> values = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::vector<int> out(10, -1);
+
+  EXPECT_EQ(queue.enqueueBulk(values.data(), 5), 5u);
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 3), 3u);
+  EXPECT_EQ(out[2], 2);
+
+  // Wraps around the end of the buffer and stops when it is full.
+  EXPECT_EQ(queue.enqueueBulk(values.data() + 5, 5), 5u);
+  EXPECT_EQ(queue.enqueueBulk(values.data(), 10), 1u);
+  EXPECT_EQ(queue.size(), 8u);
+
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 10), 8u);
+  EXPECT_EQ(out[0], 3);
+  EXPECT_EQ(out[6], 9);
+  EXPECT_EQ(out[7], 0);
+  EXPECT_EQ(queue.dequeueBulk(out.data(), 10), 0u);
+}
+
+TEST(SpscQueueTest, handoff_does_not_allocate) {
+  SpscQueue<std::string> queue(16);
+  std::string value;
+
+  EXPECT_NO_ALLOC(for (int i = 0; i < 1000; ++i) {
+    queue.emplace(8, 'a');
+    queue.tryDequeue(value);
+  });
+}
+
+TEST(SpscQueueTest, two_threads) {
+  const int count = 1000000;
+  SpscQueue<int> queue(256);
+
+  std::thread producer([&]() {
+    int batch[8];
+    for (int i = 0; i < count;) {
+      if (i % 3) {
+        if (queue.enqueue(i)) ++i;
+      } else {
+        int size = std::min(8, count - i);
+        for (int j = 0; j < size; ++j) batch[j] = i + j;
+        i += static_cast<int>(queue.enqueueBulk(batch, size));
+      }
+    }
+  });
+
+  int expected = 0;
+  int mismatches = 0;
+  int batch[5];
+  while (expected < count) {
+    if (expected % 2) {
+      int value;
+      if (queue.tryDequeue(value)) {
+        mismatches += value != expected++;
+      }
+    } else {
+      auto size = queue.dequeueBulk(batch, 5);
+      for (std::size_t j = 0; j < size; ++j) {
+        mismatches += batch[j] != expected++;
+      }
+    }
+  }
+
+  producer.join();
+  EXPECT_EQ(mismatches, 0);
+  EXPECT_TRUE(queue.isEmpty());
+}
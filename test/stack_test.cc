@@ -99,3 +99,42 @@ TEST(StackTest, to_array) {
 
   EXPECT_EQ(stack.toArray(), std::vector<int>({3, 2, 1}));
 }
+
+TEST(StackTest, push_pop_move_only) {
+  Stack<std::unique_ptr<std::string>> stack;
+
+  stack.push(std::unique_ptr<std::string>(new std::string("a")));
+  stack.emplace(new std::string("b"));
+
+  EXPECT_EQ(*stack.pop(), "b");
+  EXPECT_EQ(*stack.pop(), "a");
+  EXPECT_EQ(stack.pop(), nullptr);
+}
+
+TEST(StackTest, copy_is_independent) {
+  Stack<int> stack;
+  stack.push(1);
+  stack.push(2);
+
+  Stack<int> copy(stack);
+  EXPECT_EQ(copy.pop(), 2);
+  copy.push(3);
+
+  EXPECT_EQ(stack.toArray(), std::vector<int>({2, 1}));
+  EXPECT_EQ(copy.toArray(), std::vector<int>({3, 1}));
+}
+
+TEST(StackTest, clear_long_stack) {
+  Stack<int> stack;
+  for (int i = 0; i < 1000000; ++i) {
+    stack.push(i);
+  }
+
+  stack.clear();
+  EXPECT_TRUE(stack.isEmpty());
+
+  for (int i = 0; i < 1000000; ++i) {
+    stack.push(i);
+  }
+  EXPECT_EQ(stack.pop(), 999999);
+}
@@ -0,0 +1,186 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "stats.hpp"
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "avl_tree.hpp"
+#include "binary_search_tree.hpp"
+#include "gtest/gtest.h"
+#include "hash_table.hpp"
+#include "linked_list.hpp"
+#include "min_heap.hpp"
+#include "queue.hpp"
+#include "red_black_tree.hpp"
+#include "trie.hpp"
+
+TEST(StatsTest, reset) {
+  OperationStats stats;
+
+  stats.countComparison();
+  stats.countNodeVisit();
+  stats.countRotation();
+  stats.countAllocation();
+
+  EXPECT_EQ(stats.comparisons_, 1);
+  EXPECT_EQ(stats.node_visits_, 1);
+  EXPECT_EQ(stats.rotations_, 1);
+  EXPECT_EQ(stats.allocations_, 1);
+
+  stats.reset();
+
+  EXPECT_EQ(stats.comparisons_, 0);
+  EXPECT_EQ(stats.node_visits_, 0);
+  EXPECT_EQ(stats.rotations_, 0);
+  EXPECT_EQ(stats.allocations_, 0);
+}
+
+TEST(StatsTest, linked_list) {
+  LinkedList<int, DefaultCompare<int>, OperationStats> list;
+
+  list.append(1).append(2).prepend(0);
+  EXPECT_EQ(list.stats().allocations_, 3);
+
+  list.find(2);
+  EXPECT_EQ(list.stats().node_visits_, 3);
+  EXPECT_EQ(list.stats().comparisons_, 3);
+
+  // Both values go to the first buffer of the queue.
+  Queue<int, OperationStats> queue;
+  queue.enqueue(1);
+  queue.enqueue(2);
+  EXPECT_EQ(queue.stats().allocations_, 1);
+}
+
+TEST(StatsTest, hash_table) {
+  HashTable<int, 1, OperationStats> hashTable;
+
+  hashTable.set("a", 1);
+  hashTable.set("b", 2);
+  hashTable.set("b", 3);
+  EXPECT_EQ(hashTable.stats().allocations_, 2);
+
+  auto visited = hashTable.stats().node_visits_;
+  hashTable.get("b");
+  EXPECT_EQ(hashTable.stats().node_visits_ - visited, 2);
+}
+
+TEST(StatsTest, min_heap) {
+  MinHeap<int, DefaultCompare<int>, OperationStats> minHeap;
+
+  minHeap.add(3);
+  EXPECT_EQ(minHeap.stats().comparisons_, 0);
+
+  minHeap.add(2);
+  EXPECT_EQ(minHeap.stats().comparisons_, 1);
+
+  minHeap.add(1);
+  EXPECT_EQ(minHeap.stats().comparisons_, 2);
+
+  minHeap.poll();
+  EXPECT_EQ(minHeap.stats().comparisons_, 3);
+  EXPECT_GT(minHeap.stats().allocations_, 0);
+}
+
+TEST(StatsTest, trees) {
+  AvlTree<int, DefaultCompare<int>, OperationStats> avlTree;
+
+  avlTree.insert(1);
+  avlTree.insert(2);
+  avlTree.insert(3);
+
+  EXPECT_EQ(avlTree.stats().rotations_, 1);
+  EXPECT_EQ(avlTree.stats().allocations_, 2);
+  EXPECT_GT(avlTree.stats().comparisons_, 0);
+
+  RedBlackTree<int, DefaultCompare<int>, OperationStats> redBlackTree;
+
+  redBlackTree.insert(1);
+  redBlackTree.insert(2);
+  redBlackTree.insert(3);
+
+  EXPECT_EQ(redBlackTree.stats().rotations_, 1);
+
+  auto visited = redBlackTree.stats().node_visits_;
+  EXPECT_TRUE(redBlackTree.contains(3));
+  EXPECT_EQ(redBlackTree.stats().node_visits_ - visited, 2);
+}
+
+// Nodes count into the stats of the tree that owns them, which changes when
+// the tree moves.
+TEST(StatsTest, moved_trees) {
+  using tree_t = BinarySearchTree<int, DefaultCompare<int>, OperationStats>;
+  std::vector<tree_t> trees;
+
+  {
+    tree_t tree;
+    tree.insert(2);
+    tree.insert(1);
+    trees.push_back(std::move(tree));
+
+    tree.insert(5);
+    EXPECT_EQ(tree.toString(), "5");
+    EXPECT_EQ(tree.stats().allocations_, 0);
+  }
+
+  // Grows the vector, which moves the first tree once more.
+  trees.emplace_back();
+  trees.emplace_back();
+
+  auto comparisons = trees[0].stats().comparisons_;
+  trees[0].insert(3);
+  EXPECT_EQ(trees[0].toString(), "1,2,3");
+  EXPECT_EQ(trees[0].stats().allocations_, 2);
+  EXPECT_GT(trees[0].stats().comparisons_, comparisons);
+
+  trees[1] = std::move(trees[0]);
+  trees[1].insert(4);
+  EXPECT_EQ(trees[1].stats().allocations_, 3);
+  EXPECT_EQ(trees[0].stats().allocations_, 0);
+
+  AvlTree<int, DefaultCompare<int>, OperationStats> avlTree;
+  avlTree.insert(1);
+  auto movedAvlTree = std::move(avlTree);
+  movedAvlTree.insert(2);
+  movedAvlTree.insert(3);
+  EXPECT_EQ(movedAvlTree.stats().rotations_, 1);
+  EXPECT_EQ(movedAvlTree.stats().allocations_, 2);
+  EXPECT_EQ(movedAvlTree.toString(), "1,2,3");
+}
+
+TEST(StatsTest, no_stats_take_no_space) {
+  EXPECT_TRUE(std::is_empty<StatsHandle<NoStats>>::value);
+  EXPECT_EQ(sizeof(HashTable<int>),
+            sizeof(std::array<HashTable<int>::bucket_t, 32>));
+}
+
+TEST(StatsTest, trie) {
+  BasicTrie<OperationStats> trie;
+
+  trie.addWord("cat");
+  trie.addWord("car");
+
+  EXPECT_EQ(trie.stats().allocations_, 4);
+  EXPECT_EQ(trie.stats().node_visits_, 6);
+}
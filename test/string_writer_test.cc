@@ -0,0 +1,102 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <limits>
+#include <sstream>
+#include <string>
+#include "linked_list.hpp"
+#include "min_heap.hpp"
+#include "string_writer.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Point {
+  int x;
+  int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& point) {
+  return os << "(" << point.x << " " << point.y << ")";
+}
+
+template <typename T>
+std::string streamed(const T& value) {
+  std::stringstream ss;
+  ss << value;
+  return ss.str();
+}
+
+}  // namespace
+
+TEST(StringWriterTest, write_integers) {
+  StringWriter writer;
+
+  writer.write(0).write(',').write(-42).write(',').write(1234567890123LL);
+  EXPECT_EQ(writer.str(), "0,-42,1234567890123");
+
+  writer = StringWriter();
+  writer.write(std::numeric_limits<int>::min())
+      .write(',')
+      .write(std::numeric_limits<unsigned long long>::max());
+  EXPECT_EQ(writer.str(), streamed(std::numeric_limits<int>::min()) + "," +
+                              streamed(std::numeric_limits<
+                                       unsigned long long>::max()));
+}
+
+TEST(StringWriterTest, write_like_ostream) {
+  const double doubles[] = {0.0, -0.5, 0.1, 1.0 / 3, 1e21, 123456789.0};
+
+  for (auto value : doubles) {
+    StringWriter writer;
+    EXPECT_EQ(writer.write(value).str(), streamed(value));
+  }
+
+  StringWriter writer;
+  writer.write(1.5f).write(' ').write(true).write(' ').write('c');
+  EXPECT_EQ(writer.str(), "1.5 1 c");
+}
+
+TEST(StringWriterTest, write_strings_and_objects) {
+  StringWriter writer;
+
+  writer.write("a").write(std::string("b")).write(Point{1, 2});
+
+  EXPECT_EQ(writer.str(), "ab(1 2)");
+  EXPECT_EQ(writer.release(), "ab(1 2)");
+  EXPECT_EQ(writer.str(), "");
+}
+
+TEST(StringWriterTest, write_containers_to_stream) {
+  LinkedList<int> list;
+  MinHeap<int> minHeap;
+
+  list.append(1).append(2).append(3);
+  minHeap.add(2).add(1);
+
+  std::stringstream ss;
+  StreamWriter writer(ss);
+  list.write(writer).write(";");
+  minHeap.write(writer);
+
+  EXPECT_EQ(ss.str(), "1,2,3;1,2");
+}
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "trie.hpp"
+#include "test/allocation_counter.hpp"
 #include "gtest/gtest.h"
 
 TEST(TrieTest, create) {
@@ -73,3 +74,17 @@ TEST(TrieTest, exist) {
   EXPECT_TRUE(trie.doesWordExist("cap"));
   EXPECT_FALSE(trie.doesWordExist("call"));
 }
+
+TEST(TrieTest, lookups_do_not_allocate) {
+  Trie trie;
+
+  const std::string word = "a-word-too-long-for-small-strings";
+  const std::string longer = word + "!";
+  trie.addWord(word);
+
+  EXPECT_NO_ALLOC(EXPECT_TRUE(trie.doesWordExist(word)));
+  EXPECT_NO_ALLOC(EXPECT_FALSE(trie.doesWordExist(longer)));
+  EXPECT_NO_ALLOC(EXPECT_NE(trie.head_.getChild('a'), nullptr));
+  EXPECT_NO_ALLOC(EXPECT_TRUE(trie.head_.hasChild('a')));
+  EXPECT_NO_ALLOC(trie.head_.addChild('a'));
+}
@@ -0,0 +1,217 @@
+// MIT License
+
+// Copyright (c) 2018 Yang Le
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "unrolled_linked_list.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+TEST(UnrolledLinkedListTest, create_empty) {
+  UnrolledLinkedList<int> list;
+
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.size(), 0);
+  EXPECT_EQ(list.head(), nullptr);
+  EXPECT_EQ(list.tail(), nullptr);
+  EXPECT_EQ(list.toString(), "");
+}
+
+TEST(UnrolledLinkedListTest, append_and_prepend) {
+  UnrolledLinkedList<int, 3> list;
+
+  for (int i = 0; i < 7; ++i) {
+    list.append(i);
+  }
+  for (int i = -1; i > -5; --i) {
+    list.prepend(i);
+  }
+
+  EXPECT_EQ(list.size(), 11);
+  EXPECT_EQ(*list.head(), -4);
+  EXPECT_EQ(*list.tail(), 6);
+  EXPECT_EQ(list.toString(), "-4,-3,-2,-1,0,1,2,3,4,5,6");
+  EXPECT_EQ(list.toArray(),
+            std::vector<int>({-4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST(UnrolledLinkedListTest, prepend_then_append) {
+  UnrolledLinkedList<int, 4> list;
+
+  list.prepend(2).prepend(1).append(3).append(4).append(5);
+
+  EXPECT_EQ(list.toString(), "1,2,3,4,5");
+  EXPECT_EQ(*list.tail(), 5);
+}
+
+TEST(UnrolledLinkedListTest, remove_by_value) {
+  UnrolledLinkedList<int, 2> list;
+
+  list.append(1).append(1).append(2).append(3).append(1).append(4).append(1);
+
+  EXPECT_EQ(list.remove(1), 4);
+  EXPECT_EQ(list.toString(), "2,3,4");
+  EXPECT_EQ(list.size(), 3);
+  EXPECT_EQ(*list.head(), 2);
+  EXPECT_EQ(*list.tail(), 4);
+
+  EXPECT_EQ(list.remove(5), 0);
+  EXPECT_EQ(list.remove(4), 1);
+  EXPECT_EQ(*list.tail(), 3);
+
+  list.append(5);
+  EXPECT_EQ(list.toString(), "2,3,5");
+
+  list.remove(2);
+  list.remove(3);
+  list.remove(5);
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.head(), nullptr);
+  EXPECT_EQ(list.tail(), nullptr);
+
+  list.append(6);
+  EXPECT_EQ(list.toString(), "6");
+}
+
+TEST(UnrolledLinkedListTest, remove_value_of_the_list) {
+  UnrolledLinkedList<int, 4> list;
+  list.append(3).append(5).append(3);
+
+  EXPECT_EQ(list.remove(*list.find(3)), 2);
+  EXPECT_EQ(list.toString(), "5");
+  EXPECT_EQ(list.size(), 1);
+}
+
+TEST(UnrolledLinkedListTest, remove_merges_sparse_nodes) {
+  UnrolledLinkedList<int, 4, DefaultCompare<int>, OperationStats> list;
+  list.prepend(-1);
+  for (int i = 0; i < 100; ++i) {
+    list.append(i);
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    if (i % 4) {
+      list.remove(i);
+    }
+  }
+
+  // The 26 values left fill 7 nodes, not the 26 they were spread over.
+  EXPECT_EQ(list.size(), 26);
+  auto visited = list.stats().node_visits_;
+  EXPECT_EQ(list.find(100), nullptr);
+  EXPECT_EQ(list.stats().node_visits_ - visited, 7);
+
+  std::vector<int> expected({-1});
+  for (int i = 0; i < 100; i += 4) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(list.toArray(), expected);
+  EXPECT_EQ(*list.head(), -1);
+  EXPECT_EQ(*list.tail(), 96);
+
+  list.prepend(-2).append(100);
+  EXPECT_EQ(*list.head(), -2);
+  EXPECT_EQ(*list.tail(), 100);
+  EXPECT_EQ(list.size(), 28);
+}
+
+TEST(UnrolledLinkedListTest, delete_head) {
+  UnrolledLinkedList<std::string, 2> list;
+
+  EXPECT_FALSE(list.deleteHead());
+
+  list.append("a").append("b").append("c");
+
+  std::string value;
+  EXPECT_TRUE(list.deleteHead(&value));
+  EXPECT_EQ(value, "a");
+  EXPECT_TRUE(list.deleteHead());
+  EXPECT_EQ(list.toString(), "c");
+  EXPECT_TRUE(list.deleteHead(&value));
+  EXPECT_EQ(value, "c");
+  EXPECT_TRUE(list.isEmpty());
+  EXPECT_EQ(list.tail(), nullptr);
+}
+
+TEST(UnrolledLinkedListTest, find) {
+  UnrolledLinkedList<int, 4, DefaultCompare<int>, OperationStats> list;
+
+  EXPECT_EQ(list.find(1), nullptr);
+
+  for (int i = 0; i < 10; ++i) {
+    list.append(i);
+  }
+
+  auto isOdd = [](int value) { return value % 2 == 1; };
+
+  EXPECT_EQ(*list.find(7), 7);
+  EXPECT_EQ(list.find(10), nullptr);
+  EXPECT_EQ(*list.find(isOdd), 1);
+  EXPECT_EQ(list.find(std::function<bool(const int&)>()), nullptr);
+
+  // One node visit per four values.
+  EXPECT_EQ(list.stats().node_visits_, 2 + 3 + 1);
+}
+
+TEST(UnrolledLinkedListTest, copy_and_move) {
+  UnrolledLinkedList<std::string, 2> list;
+  list.append("a").append("b").append("c");
+
+  UnrolledLinkedList<std::string, 2> copy(list);
+  copy.append("d");
+  EXPECT_EQ(list.toString(), "a,b,c");
+  EXPECT_EQ(copy.toString(), "a,b,c,d");
+
+  UnrolledLinkedList<std::string, 2> moved(std::move(copy));
+  EXPECT_EQ(moved.toString(), "a,b,c,d");
+  EXPECT_TRUE(copy.isEmpty());
+
+  moved = list;
+  EXPECT_EQ(moved.toString(), "a,b,c");
+}
+
+TEST(UnrolledLinkedListTest, swap_keeps_stats_with_values) {
+  UnrolledLinkedList<int, 2, DefaultCompare<int>, OperationStats> list;
+  UnrolledLinkedList<int, 2, DefaultCompare<int>, OperationStats> other;
+  list.append(1).append(2).append(3);
+
+  list.swap(other);
+  EXPECT_EQ(list.stats().allocations_, 0);
+  EXPECT_EQ(other.stats().allocations_, 2);
+  EXPECT_EQ(other.toString(), "1,2,3");
+}
+
+TEST(UnrolledLinkedListTest, append_move_only) {
+  UnrolledLinkedList<std::unique_ptr<int>, 2> list;
+
+  list.append(std::unique_ptr<int>(new int(1)));
+  list.emplacePrepend(new int(0));
+  list.emplaceAppend(new int(2));
+
+  EXPECT_EQ(**list.head(), 0);
+  EXPECT_EQ(**list.tail(), 2);
+
+  std::unique_ptr<int> value;
+  list.deleteHead(&value);
+  EXPECT_EQ(*value, 0);
+  EXPECT_EQ(list.size(), 2);
+}